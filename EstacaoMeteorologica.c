@@ -2,17 +2,32 @@
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
-#include <math.h>
 #include "pico/stdlib.h"
 #include "pico/cyw43_arch.h"
+#include "pico/multicore.h"
 #include "hardware/i2c.h"
-#include "hardware/pwm.h"
 #include "hardware/pio.h"
+#include "hardware/irq.h"
 #include "lwip/tcp.h"
+#include "i2c_queue.h"
 #include "aht20.h"
 #include "bmp280.h"
-#include "ssd1306.h"
-#include "font.h"
+#include "aquisicao.h"
+#include "barometro.h"
+#include "arranjo.h"
+#include "sensores.h"
+#include "agendador.h"
+#include "seqlock.h"
+#include "buzzer.h"
+#include "matriz.h"
+#include "animacao.h"
+#include "altitude.h"
+#include "ponto_fixo.h"
+#include "estatistica.h"
+#include "tendencia.h"
+#include "adaptativo.h"
+#include "metricas.h"
+#include "telas.h"
 #include "ws2812.pio.h"
 #include "web_interface.h"
 
@@ -23,6 +38,7 @@
 #define I2C_PORT_DISP i2c1
 #define I2C_SDA_DISP 14
 #define I2C_SCL_DISP 15
+#define I2C_BAUDRATE (400 * 1000)
 #define ENDERECO_DISPLAY 0x3C
 
 #define BOTAO_A 5
@@ -34,26 +50,100 @@
 #define LED_RGB_G 11
 
 #define NUM_PIXELS 25
-#define SEA_LEVEL_PRESSURE 101325.0
+#define SEA_LEVEL_PRESSURE 101325
+#define PERFIL_BMP280 BMP280_PROFILE_STANDARD
+#define MODO_AGREGACAO AGREGACAO_VOTO   // como combinar sensores redundantes
+#define VALIDADE_DADOS_MS ARRANJO_VALIDADE_MS   // idade a partir da qual um canal é obsoleto
+#define LIMIAR_TRANSIENTE_PA 30   // variação dentro de uma janela decimada considerada transiente
+
+// Com SENSORES_SIMULADOS=1 (opção ESTACAO_SIMULADA do CMake) os sensores são
+// substituídos por um modelo de clima e a amostragem sobe até 100 Hz, para
+// exercitar display, alertas e servidor web sem hardware
+#ifndef SENSORES_SIMULADOS
+#define SENSORES_SIMULADOS 0
+#endif
+#if SENSORES_SIMULADOS
+#ifndef TAXA_SIMULACAO_HZ
+#define TAXA_SIMULACAO_HZ 100
+#endif
+#ifndef PERFIL_SIMULACAO
+#define PERFIL_SIMULACAO PERFIL_ESTRESSE
+#endif
+#if TAXA_SIMULACAO_HZ < 1 || TAXA_SIMULACAO_HZ > 100
+#error "TAXA_SIMULACAO_HZ deve ficar entre 1 e 100"
+#endif
+#define TAXA_AMOSTRAGEM_HZ TAXA_SIMULACAO_HZ
+#else
+#define TAXA_AMOSTRAGEM_HZ 1
+#endif
+#define PERIODO_AMOSTRAGEM_MS (1000 / TAXA_AMOSTRAGEM_HZ)
+// A coleta consulta os sensores mais rápido que a amostragem para não perder ciclos
+#define PERIODO_COLETA_MS (PERIODO_AMOSTRAGEM_MS < 20 ? PERIODO_AMOSTRAGEM_MS / 2 : 10)
+
+// Amostragem adaptativa (só com sensores reais): níveis do mais rápido ao mais lento,
+// com o período de disparo do AHT20 e a taxa do BMP280 decimada no mesmo período
+static const struct {
+    uint32_t periodo_ms;
+    uint16_t taxa_barometro_hz;
+} niveis_amostragem[] = {
+    {250, 25},
+    {1000, BAROMETRO_TAXA_HZ},
+    {2000, 10},
+    {5000, 5},
+};
+#define NIVEL_AMOSTRAGEM_INICIAL 1   // 1 Hz, a taxa fixa anterior
+// Derivadas que aceleram a amostragem, por minuto nas unidades internas de cada canal
+#define LIMIAR_DERIVADA_TEMP 50       // 0,5 °C/min
+#define LIMIAR_DERIVADA_UMID 300      // 3 %/min
+#define LIMIAR_DERIVADA_PRESSAO 30    // 30 Pa/min
+#define BASE_DERIVADA_MS 30000        // abaixo disso o ruído do sensor domina a derivada
+#define ESPERA_RECUO_MS 60000         // estabilidade exigida para descer um nível
+
+// Períodos e prazos das tarefas (ms); prazo 0 = igual ao período
+#define PERIODO_DISPLAY_MS 250
+#define PRAZO_DISPLAY_MS 100
+#define PERIODO_LEDS_MS 500
+#define PRAZO_LEDS_MS 50
+#define PERIODO_ALERTAS_MS 1000
+#define PRAZO_BOTOES_MS 20
+#define PRAZO_CONFIG_MS 50
+
+// Gráficos de tendência: TENDENCIA_PONTOS (128) pontos cobrindo a última hora
+#define PERIODO_TENDENCIA_MS 28125
+#define PASSO_ESCALA_TEMP 50       // 0.5 °C
+#define PASSO_ESCALA_PRESSAO 50    // 50 Pa
+
+// Comandos de configuração recebidos pela FIFO e ainda não aplicados pelo núcleo 1
+#define FILA_CONFIG 16
 
 // Configurações Wi-Fi
 #define WIFI_SSID "SEU_SSID_AQUI"
 #define WIFI_PASS "SUA_SENHA_AQUI"
 
-// Estruturas globais
+// Estruturas globais (grandezas inteiras; conversão para texto só na saída)
 typedef struct {
-    float temperatura_aht;
-    float umidade;
-    float temperatura_bmp;
-    float pressao;
-    float altitude;
+    int32_t temperatura_aht;  // 0.01 °C (média AHT20/BMP280, ou só AHT20 sem barômetro recente)
+    int32_t umidade;          // 0.01 %
+    int32_t temperatura_bmp;  // 0.01 °C
+    int32_t pressao;          // Pa
+    int32_t altitude;         // dm
+    uint8_t obsoletos;        // OBSOLETO_*: canais sem leitura boa recente
     bool wifi_conectado;
 } DadosSensores;
 
-typedef enum {
-    TELA_SENSORES,
-    TELA_WIFI
-} TipoTela;
+// Bits de DadosSensores.obsoletos
+#define OBSOLETO_TEMP_UMID 0x01
+#define OBSOLETO_PRESSAO   0x02
+
+// Extremos da última janela decimada do barômetro e transientes vistos nelas: portas
+// batendo e rajadas aparecem como picos que a média da janela esconde
+typedef struct {
+    int32_t min;             // Pa, offset aplicado
+    int32_t max;
+    uint32_t transientes;    // janelas com max - min >= LIMIAR_TRANSIENTE_PA
+    uint32_t ultimo_pa;      // amplitude do transiente mais recente
+    uint32_t ultimo_ms;      // quando ele ocorreu
+} JanelaPressao;
 
 typedef enum {
     STATUS_TEMPERATURA,
@@ -62,6 +152,46 @@ typedef enum {
     STATUS_ALTITUDE
 } TipoStatus;
 
+// Canais com filtro de mediana e estatísticas de janela
+typedef enum {
+    CANAL_TEMPERATURA,
+    CANAL_UMIDADE,
+    CANAL_PRESSAO,
+    CANAL_ALTITUDE,
+    NUM_CANAIS
+} IdCanal;
+
+// Cópia publicada pelo núcleo 1 (aquisição/renderização) para o servidor web no núcleo 0
+typedef struct {
+    DadosSensores dados;
+    ResumoEstat resumo[NUM_CANAIS][NUM_JANELAS];
+    uint32_t espurias[NUM_CANAIS];
+    JanelaPressao janela_pressao;
+    SensorArranjo sensores[ARRANJO_MAX_SENSORES];
+    uint8_t num_sensores;
+    uint8_t modo_agregacao;
+    int32_t offset_temp;
+    int32_t offset_humid;
+    int32_t offset_press;
+    int32_t offset_alt;
+    uint32_t periodo_amostragem_ms;
+    uint8_t motivo_amostragem;     // MotivoTaxa
+    uint8_t canal_amostragem;      // canal que motivou a última aceleração
+} Instantaneo;
+
+// Configuração enviada do núcleo 0 ao núcleo 1 pela FIFO entre núcleos: uma palavra
+// por comando, com o comando nos 4 bits altos e o valor com sinal nos 28 restantes
+typedef enum {
+    CFG_OFFSET_TEMP,
+    CFG_OFFSET_UMID,
+    CFG_OFFSET_PRESSAO,
+    CFG_OFFSET_ALT,
+    CFG_REFERENCIA_P0,
+    CFG_AGREGACAO
+} ComandoConfig;
+
+#define CFG_VALOR_MAX ((1 << 27) - 1)
+
 typedef enum {
     NIVEL_BOM,
     NIVEL_ALERTA,
@@ -71,99 +201,136 @@ typedef enum {
 // Variáveis globais
 DadosSensores dados_sensores = {0};
 TipoTela tela_atual = TELA_SENSORES;
+Telas telas;
+Tendencia tendencia_temperatura;
+Tendencia tendencia_pressao;
 TipoStatus status_atual = STATUS_TEMPERATURA;
 ssd1306_t ssd;
+i2c_queue_t fila_i2c;
+i2c_queue_t fila_i2c_disp;   // sensores extras no barramento do display
+ArranjoSensores arranjo;
+Buzzer buzzer;
+BackendSensores *sensores;
+Agendador agendador;        // núcleo 1: sensores, display, LEDs, alertas
+int tarefa_botoes = -1;
+int tarefa_display = -1;
+int tarefa_config = -1;
+int tarefa_amostragem = -1;
+Adaptativo adaptativo;
+uint32_t periodo_amostragem_ms = PERIODO_AMOSTRAGEM_MS;
+Instantaneo instantaneo;
+SeqLock seq_instantaneo;
+volatile uint32_t fila_config[FILA_CONFIG];
+volatile uint16_t fila_config_head = 0;
+uint16_t fila_config_tail = 0;
+CanalEstat canais[NUM_CANAIS];
+
+// Métricas de desempenho expostas em /metrics; cada uma só é escrita por um núcleo
+Histograma hist_envio_display;       // núcleo 1: ssd1306_send_data
+Histograma hist_http;                // núcleo 0: tratamento de uma requisição
+uint32_t http_requisicoes = 0;
+uint32_t http_bytes_enviados = 0;
+uint32_t http_falhas_alocacao = 0;   // malloc do estado ou tcp_write sem memória
+uint32_t falhas_display = 0;         // quadros não entregues (timeout ou NACK no i2c1)
+uint32_t ultima_amostra_ms = 0;      // última amostra boa de temperatura/umidade
+uint32_t ultimo_barometro_ms = 0;    // última leitura boa de pressão
+bool barometro_lido = false;         // ultimo_barometro_ms e temperatura_bmp já valem
+JanelaPressao janela_pressao;        // núcleo 1; /metrics lê os contadores direto
 PIO pio = pio0;
 int sm = 0;
+MatrizLeds matriz;
+Animacao animacao;
 char ip_str[24] = "0.0.0.0";
 volatile bool botao_a_pressionado = false;
 volatile bool botao_b_pressionado = false;
 volatile uint32_t ultimo_debounce_a = 0;
 volatile uint32_t ultimo_debounce_b = 0;
 
-// Variáveis de offset de calibração
-float offset_temp = 0.0;
-float offset_humid = 0.0;
-float offset_press = 0.0;
-float offset_alt = 0.0;
+// Variáveis de offset de calibração (mesmas unidades de DadosSensores); só o núcleo 1
+// as altera, a partir dos comandos da FIFO
+int32_t offset_temp = 0;   // 0.01 °C
+int32_t offset_humid = 0;  // 0.01 %
+int32_t offset_press = 0;  // Pa
+int32_t offset_alt = 0;    // dm
 
 
+// Formatação de cada canal no JSON: chave, casas do valor interno e casas publicadas
+static const struct {
+    const char *chave;
+    uint8_t casas_valor;
+    uint8_t casas_saida;
+} formato_canais[NUM_CANAIS] = {
+    [CANAL_TEMPERATURA] = {"t", 2, 2},  // °C
+    [CANAL_UMIDADE]     = {"h", 2, 2},  // %
+    [CANAL_PRESSAO]     = {"p", 3, 3},  // Pa -> kPa
+    [CANAL_ALTITUDE]    = {"a", 1, 1},  // dm -> m
+};
+
 // Nomes dos status para exibição no display
 const char* nomes_status[] = {"Temperatura", "Umidade", "Pressao", "Altitude"};
 
-// Padrões para matriz de LEDs
-static const bool padrao_bom[NUM_PIXELS] = {
-    0,0,1,0,0,
-    0,1,1,1,0,
-    1,1,1,1,1,
-    0,1,1,1,0,
-    0,0,1,0,0
-};
+// Sons: cliques dos botões e alerta de duas notas
+static const Nota notas_botao_a[] = {{1200, 100, 0}};
+static const Nota notas_botao_b[] = {{800, 100, 0}};
+static const Nota notas_alerta[] = {{800, 200, 100}, {1000, 200, 0}};
+static const PadraoSom som_botao_a = {notas_botao_a, count_of(notas_botao_a), 1};
+static const PadraoSom som_botao_b = {notas_botao_b, count_of(notas_botao_b), 1};
+static const PadraoSom som_alerta = {notas_alerta, count_of(notas_alerta), 1};
+
+// Quadros da matriz de LEDs em cor linear; gama e brilho são aplicados na saída
+#define MASCARA_BOM     ANIM_MASCARA(0b00100, 0b01110, 0b11111, 0b01110, 0b00100)
+#define MASCARA_ALERTA  ANIM_MASCARA(0b00100, 0b00100, 0b01110, 0b11111, 0b00000)
+#define MASCARA_CRITICO ANIM_MASCARA(0b10001, 0b01010, 0b00100, 0b01010, 0b10001)
+
+static const QuadroLed quadro_bom = ANIM_QUADRO(MASCARA_BOM, 0, 255, 0);
+static const QuadroLed quadro_alerta = ANIM_QUADRO(MASCARA_ALERTA, 255, 128, 0);
+static const QuadroLed quadro_alerta_fraco = ANIM_QUADRO(MASCARA_ALERTA, 96, 48, 0);
+static const QuadroLed quadro_critico = ANIM_QUADRO(MASCARA_CRITICO, 255, 0, 0);
+static const QuadroLed quadro_critico_fraco = ANIM_QUADRO(MASCARA_CRITICO, 48, 0, 0);
+
+// Bom fica parado; alerta pulsa devagar, crítico rápido
+static const QuadroChave chaves_bom[] = {{&quadro_bom, 0}};
+static const QuadroChave chaves_alerta[] = {{&quadro_alerta, 900}, {&quadro_alerta_fraco, 900}};
+static const QuadroChave chaves_critico[] = {{&quadro_critico, 250}, {&quadro_critico_fraco, 250}};
 
-static const bool padrao_alerta[NUM_PIXELS] = {
-    0,0,1,0,0,
-    0,0,1,0,0,
-    0,1,1,1,0,
-    1,1,1,1,1,
-    0,0,0,0,0
+static const Sequencia sequencias_nivel[] = {
+    [NIVEL_BOM] = {chaves_bom, count_of(chaves_bom), false},
+    [NIVEL_ALERTA] = {chaves_alerta, count_of(chaves_alerta), true},
+    [NIVEL_CRITICO] = {chaves_critico, count_of(chaves_critico), true},
 };
 
-static const bool padrao_critico[NUM_PIXELS] = {
-    1,0,0,0,1,
-    0,1,0,1,0,
-    0,0,1,0,0,
-    0,1,0,1,0,
-    1,0,0,0,1
+// Barra mostrada ao trocar a grandeza com o botão A: posição do valor nesta faixa
+#define DURACAO_BARRA_MS 1500
+static const struct {
+    int32_t min, max;
+    CorLed cor;
+} faixas_barra[] = {
+    [STATUS_TEMPERATURA] = {0, 4000, {255, 96, 0}},       // 0..40 °C
+    [STATUS_UMIDADE] = {0, 10000, {0, 96, 255}},          // 0..100 %
+    [STATUS_PRESSAO] = {95000, 105000, {160, 0, 255}},    // 95..105 kPa
+    [STATUS_ALTITUDE] = {0, 10000, {255, 255, 255}},      // 0..1000 m
 };
 
 // Protótipos de funções
 void init_hardware(void);
 void init_wifi(void);
-void init_sensores(void);
-void ler_sensores(void);
+void init_sensores(alarm_pool_t *pool);
+void processar_amostra(const AmostraSensores *amostra);
+void processar_barometro(const LeituraBarometro *leitura);
 void atualizar_display(void);
+void enviar_display(void);
+void publicar_instantaneo(void);
+void ler_instantaneo(Instantaneo *out);
 void atualizar_matriz_leds(void);
+void mostrar_barra_status(void);
 void atualizar_led_rgb(void);
 void verificar_alertas(void);
-NivelStatus avaliar_temperatura(float temp);
-NivelStatus avaliar_umidade(float umidade);
-NivelStatus avaliar_pressao(float pressao);
+NivelStatus avaliar_temperatura(int32_t temp);
+NivelStatus avaliar_umidade(int32_t umidade);
+NivelStatus avaliar_pressao(int32_t pressao);
 void gpio_irq_handler(uint gpio, uint32_t events);
 void start_http_server(void);
 
-// Funções para matriz de LEDs
-uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b) {
-    return ((uint32_t)(r) << 8) | ((uint32_t)(g) << 16) | (uint32_t)(b);
-}
-
-void put_pixel(uint32_t pixel_grb) {
-    pio_sm_put_blocking(pio, sm, pixel_grb << 8u);
-}
-
-void display_matriz(const bool *buffer, uint8_t r, uint8_t g, uint8_t b) {
-    uint32_t color = urgb_u32(r, g, b);
-    for (int i = 0; i < NUM_PIXELS; i++) {
-        put_pixel(buffer[i] ? color : 0);
-    }
-}
-
-// Função para tocar som no buzzer
-void play_sound(int frequency, int duration_ms) {
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    if (frequency <= 0) {
-        pwm_set_gpio_level(BUZZER_PIN, 0);
-        sleep_ms(duration_ms);
-        return;
-    }
-    float divider = 20.0f;
-    pwm_set_clkdiv(slice_num, divider);
-    uint16_t wrap = (125000000 / (frequency * divider)) - 1;
-    pwm_set_wrap(slice_num, wrap);
-    pwm_set_gpio_level(BUZZER_PIN, wrap / 2);
-    sleep_ms(duration_ms);
-    pwm_set_gpio_level(BUZZER_PIN, 0);
-}
-
 // Tratamento de interrupções dos botões
 void gpio_irq_handler(uint gpio, uint32_t events) {
     uint32_t now = to_ms_since_boot(get_absolute_time());
@@ -171,101 +338,594 @@ void gpio_irq_handler(uint gpio, uint32_t events) {
     if (gpio == BOTAO_A && (now - ultimo_debounce_a) > 200) {
         botao_a_pressionado = true;
         ultimo_debounce_a = now;
+        agendador_sinalizar(&agendador, tarefa_botoes);
     } else if (gpio == BOTAO_B && (now - ultimo_debounce_b) > 200) {
         botao_b_pressionado = true;
         ultimo_debounce_b = now;
+        agendador_sinalizar(&agendador, tarefa_botoes);
     }
 }
 
 // Avaliação de níveis dos sensores
-NivelStatus avaliar_temperatura(float temp) {
-    if (temp < 10 || temp > 40) return NIVEL_CRITICO;
-    if (temp > 35) return NIVEL_ALERTA;
+// temp em 0.01 °C
+NivelStatus avaliar_temperatura(int32_t temp) {
+    if (temp < 1000 || temp > 4000) return NIVEL_CRITICO;
+    if (temp > 3500) return NIVEL_ALERTA;
     return NIVEL_BOM;
 }
 
-NivelStatus avaliar_umidade(float umidade) {
-    if (umidade < 30 || umidade > 80) return NIVEL_CRITICO;
-    if (umidade < 40 || umidade > 70) return NIVEL_ALERTA;
+// umidade em 0.01 %
+NivelStatus avaliar_umidade(int32_t umidade) {
+    if (umidade < 3000 || umidade > 8000) return NIVEL_CRITICO;
+    if (umidade < 4000 || umidade > 7000) return NIVEL_ALERTA;
     return NIVEL_BOM;
 }
 
-NivelStatus avaliar_pressao(float pressao) {
-    float pressao_kpa = pressao / 1000.0;
-    if (pressao_kpa < 95 || pressao_kpa > 105) return NIVEL_CRITICO;
-    if (pressao_kpa < 98 || pressao_kpa > 102) return NIVEL_ALERTA;
+// pressao em Pa
+NivelStatus avaliar_pressao(int32_t pressao) {
+    if (pressao < 95000 || pressao > 105000) return NIVEL_CRITICO;
+    if (pressao < 98000 || pressao > 102000) return NIVEL_ALERTA;
     return NIVEL_BOM;
 }
 
-// Estrutura para HTTP
+// Lê "chave=valor" da query string para um inteiro com 'casas' casas implícitas. A chave
+// só vale no início de um parâmetro ("p0=" não casa com "xp0=") e o valor tem de ser
+// inteiro um número até o '&' ou o fim ("101800junk" é recusado)
+static bool ler_parametro(const char *query, const char *chave, uint8_t casas, int32_t *destino) {
+    size_t tam_chave = strlen(chave);
+    for (const char *pos = strstr(query, chave); pos; pos = strstr(pos + 1, chave)) {
+        if (pos != query && pos[-1] != '&') {
+            continue;
+        }
+        const char *valor = pos + tam_chave;
+        size_t tam_valor = strcspn(valor, "& ");
+        return tam_valor > 0 && strspn(valor, "+-.0123456789") >= tam_valor &&
+               fixo_interpretar(valor, casas, destino);
+    }
+    return false;
+}
+
+// --- Troca de dados entre núcleos ---
+
+// Núcleo 1: monta a cópia fora da seção de escrita, que fica reduzida a um memcpy
+void publicar_instantaneo(void) {
+    static Instantaneo rascunho;
+    rascunho.dados = dados_sensores;
+    for (int c = 0; c < NUM_CANAIS; c++) {
+        for (int j = 0; j < NUM_JANELAS; j++) {
+            canal_estat_resumo(&canais[c], (IdJanela)j, &rascunho.resumo[c][j]);
+        }
+        rascunho.espurias[c] = canais[c].espurias;
+    }
+    rascunho.janela_pressao = janela_pressao;
+    memcpy(rascunho.sensores, arranjo.sensores, sizeof(rascunho.sensores));
+    rascunho.num_sensores = arranjo.num_sensores;
+    rascunho.modo_agregacao = (uint8_t)arranjo.modo;
+    rascunho.offset_temp = offset_temp;
+    rascunho.offset_humid = offset_humid;
+    rascunho.offset_press = offset_press;
+    rascunho.offset_alt = offset_alt;
+    rascunho.periodo_amostragem_ms = periodo_amostragem_ms;
+    rascunho.motivo_amostragem = (uint8_t)adaptativo.motivo;
+    rascunho.canal_amostragem = adaptativo.canal_motivo;
+
+    seqlock_escrita_inicio(&seq_instantaneo);
+    instantaneo = rascunho;
+    seqlock_escrita_fim(&seq_instantaneo);
+}
+
+// Núcleo 0: copia até obter uma versão que não cruzou nenhuma publicação
+void ler_instantaneo(Instantaneo *out) {
+    uint32_t v;
+    do {
+        v = seqlock_leitura_inicio(&seq_instantaneo);
+        *out = instantaneo;
+    } while (seqlock_leitura_repetir(&seq_instantaneo, v));
+}
+
+// Núcleo 0: envia um comando ao núcleo 1 sem bloquear o lwIP por muito tempo
+static bool enviar_config(ComandoConfig cmd, int32_t valor) {
+    if (valor > CFG_VALOR_MAX || valor < -CFG_VALOR_MAX) {
+        return false;
+    }
+    uint32_t palavra = ((uint32_t)cmd << 28) | ((uint32_t)valor & 0x0FFFFFFF);
+    return multicore_fifo_push_timeout_us(palavra, 1000);
+}
+
+// Núcleo 1: esvazia a FIFO para a fila de comandos; a tarefa de configuração aplica
+static void fifo_irq_handler(void) {
+    while (multicore_fifo_rvalid()) {
+        uint32_t palavra = multicore_fifo_pop_blocking();
+        uint16_t head = fila_config_head;
+        if ((uint16_t)(head - fila_config_tail) < FILA_CONFIG) {
+            fila_config[head % FILA_CONFIG] = palavra;
+            fila_config_head = head + 1;
+        }
+    }
+    multicore_fifo_clear_irq();
+    agendador_sinalizar(&agendador, tarefa_config);
+}
+
+// Monta o JSON de estatísticas: para cada canal, janelas de 1 e 10 min e espúrias rejeitadas,
+// seguidas do período de amostragem em uso e do que o determinou
+static int json_estatisticas(char *buf, size_t tam, const Instantaneo *snap) {
+    static const char *nomes_janela[] = {"1m", "10m"};
+    int len = snprintf(buf, tam, "{");
+
+    for (int c = 0; c < NUM_CANAIS; c++) {
+        uint8_t cv = formato_canais[c].casas_valor;
+        uint8_t cs = formato_canais[c].casas_saida;
+        len += snprintf(buf + len, tam - len, "%s\"%s\":{", c ? "," : "", formato_canais[c].chave);
+
+        for (int j = 0; j < NUM_JANELAS; j++) {
+            const ResumoEstat *r = &snap->resumo[c][j];
+            char media[14], desvio[14], min[14], max[14];
+            fixo_formatar(media, sizeof(media), r->media, cv, cs);
+            fixo_formatar(desvio, sizeof(desvio), r->desvio, cv, cs);
+            fixo_formatar(min, sizeof(min), r->min, cv, cs);
+            fixo_formatar(max, sizeof(max), r->max, cv, cs);
+            len += snprintf(buf + len, tam - len,
+                            "\"%s\":{\"n\":%lu,\"med\":%s,\"dp\":%s,\"min\":%s,\"max\":%s},",
+                            nomes_janela[j], (unsigned long)r->n, media, desvio, min, max);
+        }
+        if (c == CANAL_PRESSAO) {
+            // Extremos da última janela decimada e transientes (idade em s; -1 = nenhum)
+            const JanelaPressao *jp = &snap->janela_pressao;
+            char min[14], max[14];
+            fixo_formatar(min, sizeof(min), jp->min, cv, cs);
+            fixo_formatar(max, sizeof(max), jp->max, cv, cs);
+            uint32_t agora = to_ms_since_boot(get_absolute_time());
+            long idade = jp->transientes ? (long)((agora - jp->ultimo_ms) / 1000) : -1;
+            len += snprintf(buf + len, tam - len,
+                            "\"jan\":{\"min\":%s,\"max\":%s},\"trans\":{\"n\":%lu,\"pa\":%lu,\"idade_s\":%ld},",
+                            min, max, (unsigned long)jp->transientes, (unsigned long)jp->ultimo_pa, idade);
+        }
+        len += snprintf(buf + len, tam - len, "\"esp\":%lu}", (unsigned long)snap->espurias[c]);
+    }
+
+    len += snprintf(buf + len, tam - len, ",\"amostragem\":{\"ms\":%lu,\"motivo\":\"%s\"",
+                    (unsigned long)snap->periodo_amostragem_ms,
+                    adaptativo_nome_motivo((MotivoTaxa)snap->motivo_amostragem));
+    if (snap->motivo_amostragem == MOTIVO_VARIACAO) {
+        len += snprintf(buf + len, tam - len, ",\"canal\":\"%s\"", formato_canais[snap->canal_amostragem].chave);
+    }
+    len += snprintf(buf + len, tam - len, "}}");
+    return len;
+}
+
+// Texto de exposição do Prometheus. Os contadores do núcleo 1 são lidos direto: cada
+// um é uma palavra escrita só por ele, e o Prometheus tolera uma amostra atrasada.
+// O núcleo 0 não tem agendador (o lwIP roda na IRQ do cyw43): a carga dele aparece no
+// histograma da etapa "http".
+static int texto_metricas(char *buf, size_t tam) {
+    char rotulos[40];
+    int len = 0;
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_tarefa_segundos", "histogram",
+                              "Tempo de execucao de cada ativacao de tarefa");
+    for (int i = 0; i < agendador.num_tarefas; i++) {
+        const Tarefa *t = &agendador.tarefas[i];
+        snprintf(rotulos, sizeof(rotulos), "tarefa=\"%s\"", t->nome);
+        len += metricas_histograma(buf + len, tam - len, "estacao_tarefa_segundos", rotulos, &t->duracao);
+    }
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_etapa_segundos", "histogram",
+                              "Tempo das etapas internas das tarefas");
+    len += metricas_histograma(buf + len, tam - len, "estacao_etapa_segundos", "etapa=\"envio_display\"",
+                               &hist_envio_display);
+    len += metricas_histograma(buf + len, tam - len, "estacao_etapa_segundos", "etapa=\"http\"", &hist_http);
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_tarefa_overruns_total", "counter",
+                              "Ativacoes terminadas depois do prazo");
+    for (int i = 0; i < agendador.num_tarefas; i++) {
+        const Tarefa *t = &agendador.tarefas[i];
+        snprintf(rotulos, sizeof(rotulos), "tarefa=\"%s\"", t->nome);
+        len += metricas_valor(buf + len, tam - len, "estacao_tarefa_overruns_total", rotulos, t->overruns);
+    }
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_ocioso_razao", "gauge",
+                              "Fracao do ultimo segundo parada em __wfe");
+    len += metricas_valor_fixo(buf + len, tam - len, "estacao_ocioso_razao", "nucleo=\"1\"",
+                               agendador.ocioso_permil, 3);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_ocioso_segundos_total", "counter",
+                              "Tempo total parado em __wfe");
+    len += metricas_valor_fixo(buf + len, tam - len, "estacao_ocioso_segundos_total", "nucleo=\"1\"",
+                               agendador.ocioso_ms, 3);
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_pressao_transientes_total", "counter",
+                              "Janelas decimadas do barometro com variacao acima do limiar");
+    len += metricas_valor(buf + len, tam - len, "estacao_pressao_transientes_total", NULL,
+                          janela_pressao.transientes);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_pressao_janela_pa", "gauge",
+                              "Extremos da ultima janela decimada do barometro");
+    len += metricas_valor(buf + len, tam - len, "estacao_pressao_janela_pa", "extremo=\"min\"",
+                          (uint32_t)janela_pressao.min);
+    len += metricas_valor(buf + len, tam - len, "estacao_pressao_janela_pa", "extremo=\"max\"",
+                          (uint32_t)janela_pressao.max);
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_i2c_recuperacoes_total", "counter",
+                              "Bus clears feitos em cada barramento");
+    i2c_queue_t *const filas[] = {&fila_i2c, &fila_i2c_disp};
+    for (int b = 0; b < 2; b++) {
+        snprintf(rotulos, sizeof(rotulos), "bus=\"%d\"", b);
+        len += metricas_valor(buf + len, tam - len, "estacao_i2c_recuperacoes_total", rotulos, filas[b]->recoveries);
+    }
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_display_falhas_total", "counter",
+                              "Quadros do display nao entregues");
+    len += metricas_valor(buf + len, tam - len, "estacao_display_falhas_total", NULL,
+                          falhas_display + ssd.tx_failures);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_display_quadros_descartados_total", "counter",
+                              "Trocas recusadas com o quadro anterior ainda em transito");
+    len += metricas_valor(buf + len, tam - len, "estacao_display_quadros_descartados_total", NULL,
+                          ssd.frames_dropped);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_display_bytes_total", "counter",
+                              "Bytes de imagem enviados ao display (so janelas alteradas)");
+    len += metricas_valor(buf + len, tam - len, "estacao_display_bytes_total", NULL, ssd.bytes_sent);
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_matriz_quadros_total", "counter",
+                              "Quadros da matriz de LEDs por resultado");
+    len += metricas_valor(buf + len, tam - len, "estacao_matriz_quadros_total", "resultado=\"enviado\"",
+                          matriz.enviados);
+    len += metricas_valor(buf + len, tam - len, "estacao_matriz_quadros_total", "resultado=\"suprimido\"",
+                          matriz.suprimidos);
+    len += metricas_valor(buf + len, tam - len, "estacao_matriz_quadros_total", "resultado=\"adiado\"",
+                          matriz.adiados);
+
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_http_requisicoes_total", "counter",
+                              "Requisicoes HTTP atendidas");
+    len += metricas_valor(buf + len, tam - len, "estacao_http_requisicoes_total", NULL, http_requisicoes);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_http_bytes_enviados_total", "counter",
+                              "Bytes de resposta confirmados pelo TCP");
+    len += metricas_valor(buf + len, tam - len, "estacao_http_bytes_enviados_total", NULL, http_bytes_enviados);
+    len += metricas_cabecalho(buf + len, tam - len, "estacao_http_falhas_alocacao_total", "counter",
+                              "Respostas descartadas por falta de memoria");
+    len += metricas_valor(buf + len, tam - len, "estacao_http_falhas_alocacao_total", NULL, http_falhas_alocacao);
+    return len;
+}
+
+// Lista os sensores do arranjo (id < 0) ou só o sensor id, com a última leitura de cada um
+static int json_sensores(char *buf, size_t tam, int id, const Instantaneo *snap) {
+    int primeiro = id < 0 ? 0 : id;
+    int ultimo = id < 0 ? snap->num_sensores : id + 1;
+    int len = snprintf(buf, tam, id < 0 ? "{\"agr\":%d,\"sensores\":[" : "", (int)snap->modo_agregacao);
+
+    for (int i = primeiro; i < ultimo && len < (int)tam; i++) {
+        const SensorArranjo *s = &snap->sensores[i];
+        char t[12], v[12];
+        bool aht20 = s->tipo == SENSOR_AHT20;
+        fixo_formatar(t, sizeof(t), s->temperatura, 2, 2);
+        fixo_formatar(v, sizeof(v), s->valor, aht20 ? 2 : 3, aht20 ? 2 : 3);  // % ou kPa
+        len += snprintf(buf + len, tam - len,
+                        "%s{\"id\":%d,\"tipo\":\"%s\",\"bus\":%u,\"end\":%u,\"ok\":%s,\"obs\":%s,"
+                        "\"t\":%s,\"%s\":%s,\"n\":%lu,\"f\":%lu,\"idade_ms\":%lu,"
+                        "\"i2c\":{\"ok\":%lu,\"nack\":%lu,\"to\":%lu,\"err\":%lu}}",
+                        i > primeiro ? "," : "", i, aht20 ? "aht20" : "bmp280", s->barramento, s->endereco,
+                        s->valido ? "true" : "false", s->obsoleto ? "true" : "false", t, aht20 ? "h" : "p", v,
+                        (unsigned long)s->leituras, (unsigned long)s->falhas, (unsigned long)s->idade_ms,
+                        (unsigned long)s->i2c_ok, (unsigned long)s->nacks, (unsigned long)s->timeouts,
+                        (unsigned long)s->erros);
+    }
+
+    if (id < 0) {
+        len += snprintf(buf + len, tam - len, "]}");
+    }
+    return len;
+}
+
+// Respostas fixas, direto da flash
+static const char RESPOSTA_400[] =
+    "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPOSTA_404[] =
+    "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+static const char RESPOSTA_CONFIG_OK[] =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\nConnection: close\r\n\r\nOK";
+
+// Respostas montadas na hora: cabeçalho no início do buffer da conexão e corpo a partir
+// de CABECALHO_RESPOSTA, enviados como dois trechos sem juntar
+#define CABECALHO_RESPOSTA 128
+#define RESPOSTA_METRICAS 10240  // cabe o pior caso de /metrics (~9,3 KB)
+#define RESPOSTA_STATS (CABECALHO_RESPOSTA + 1280)
+#define RESPOSTA_SENSORES (CABECALHO_RESPOSTA + 2048)
+#define RESPOSTA_D (CABECALHO_RESPOSTA + 128)
+
+// Cabeçalho da página com o Content-Length de HTML_BODY, montado uma vez em
+// start_http_server: o cliente sabe onde a página acaba sem esperar o fechamento
+static char cabecalho_pagina[CABECALHO_RESPOSTA];
+static int tam_cabecalho_pagina;
+
+typedef enum {
+    ROTA_PAGINA,
+    ROTA_METRICS,
+    ROTA_STATS,
+    ROTA_SENSORES,
+    ROTA_D,
+    ROTA_CONFIG,
+    ROTA_INVALIDA
+} RotaHttp;
+
+// Buffer da resposta de cada rota (0 = só trechos em flash)
+static const size_t tamanho_resposta[] = {
+    [ROTA_PAGINA] = 0,
+    [ROTA_METRICS] = RESPOSTA_METRICAS,
+    [ROTA_STATS] = RESPOSTA_STATS,
+    [ROTA_SENSORES] = RESPOSTA_SENSORES,
+    [ROTA_D] = RESPOSTA_D,
+    [ROTA_CONFIG] = 0,
+    [ROTA_INVALIDA] = 0,
+};
+
+// Maior linha de requisição aceita; /set_config com todos os parâmetros fica bem abaixo
+#define LINHA_REQUISICAO 256
+
+// Estado de uma conexão: a resposta em até dois trechos (flash ou response[]), entregue
+// ao lwIP sem cópia conforme o buffer de envio libera. Os trechos precisam continuar
+// válidos até a confirmação, por isso o estado só é liberado no fim (ou no abort)
 struct http_state {
-    char response[8192];
-    size_t len;
-    size_t sent;
+    const char *trecho[2];
+    size_t tam[2];
+    size_t total;
+    size_t enfileirado;   // já entregue ao tcp_write
+    size_t confirmado;    // já confirmado pelo cliente
+    char response[];
 };
 
+static RotaHttp http_rota(const char *req) {
+    if (strstr(req, "GET /metrics")) return ROTA_METRICS;
+    if (strstr(req, "GET /stats")) return ROTA_STATS;
+    if (strstr(req, "GET /sensores")) return ROTA_SENSORES;
+    if (strstr(req, "GET /d")) return ROTA_D;
+    if (strstr(req, "GET /set_config")) return ROTA_CONFIG;
+    return ROTA_PAGINA;
+}
+
+static void http_trechos(struct http_state *hs, const char *cab, size_t cab_len, const char *corpo, size_t corpo_len) {
+    hs->trecho[0] = cab;
+    hs->tam[0] = cab_len;
+    hs->trecho[1] = corpo;
+    hs->tam[1] = corpo_len;
+    hs->total = cab_len + corpo_len;
+}
+
+// Corpo já montado em response + CABECALHO_RESPOSTA: falta só o cabeçalho. Um corpo
+// truncado pelo snprintf é cortado no que de fato está no buffer
+static void http_dinamica(struct http_state *hs, const char *tipo, int corpo_len, size_t tam_corpo) {
+    if (corpo_len < 0) {
+        corpo_len = 0;
+    } else if ((size_t)corpo_len >= tam_corpo) {
+        corpo_len = (int)tam_corpo - 1;
+    }
+    int cab_len = snprintf(hs->response, CABECALHO_RESPOSTA,
+                           "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+                           tipo, corpo_len);
+    http_trechos(hs, hs->response, cab_len, hs->response + CABECALHO_RESPOSTA, corpo_len);
+}
+
+static void http_encerrar(struct tcp_pcb *tpcb, struct http_state *hs) {
+    tcp_arg(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    tcp_err(tpcb, NULL);
+    free(hs);
+}
+
+// Entrega ao lwIP o quanto couber no buffer de envio; o resto segue a cada http_sent
+// (ou no http_poll, se a fila de segmentos estava cheia sem nada em trânsito)
+static err_t http_enviar(struct tcp_pcb *tpcb, struct http_state *hs) {
+    while (hs->enfileirado < hs->total) {
+        size_t livre = tcp_sndbuf(tpcb);
+        if (livre == 0) {
+            break;
+        }
+        uint8_t t = hs->enfileirado < hs->tam[0] ? 0 : 1;
+        size_t pos = t ? hs->enfileirado - hs->tam[0] : hs->enfileirado;
+        size_t n = hs->tam[t] - pos;
+        if (n > livre) {
+            n = livre;
+        }
+        uint8_t flags = hs->enfileirado + n < hs->total ? TCP_WRITE_FLAG_MORE : 0;
+        err_t e = tcp_write(tpcb, hs->trecho[t] + pos, (u16_t)n, flags);
+        if (e == ERR_MEM) {
+            break;
+        }
+        if (e != ERR_OK) {
+            return e;
+        }
+        hs->enfileirado += n;
+    }
+    return tcp_output(tpcb);
+}
+
 static err_t http_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
     struct http_state *hs = (struct http_state *)arg;
-    hs->sent += len;
-    if (hs->sent >= hs->len) {
+    if (!hs) {
+        return ERR_OK;
+    }
+    hs->confirmado += len;
+    http_bytes_enviados += len;
+    if (hs->confirmado >= hs->total) {
+        http_encerrar(tpcb, hs);
         tcp_close(tpcb);
-        free(hs);
+        return ERR_OK;
+    }
+    return http_enviar(tpcb, hs);
+}
+
+static err_t http_poll(void *arg, struct tcp_pcb *tpcb) {
+    struct http_state *hs = (struct http_state *)arg;
+    if (hs && hs->enfileirado < hs->total) {
+        http_enviar(tpcb, hs);
     }
     return ERR_OK;
 }
 
+// A pcb já foi liberada pelo lwIP: só resta o estado
+static void http_err(void *arg, err_t err) {
+    free(arg);
+}
+
+// Aborta a conexão com dados ainda referenciados pelo lwIP: depois do abort nada mais
+// aponta para os trechos e o estado pode ser liberado
+static err_t http_abortar(struct tcp_pcb *tpcb, struct http_state *hs) {
+    http_encerrar(tpcb, hs);
+    tcp_abort(tpcb);
+    return ERR_ABRT;
+}
+
 static err_t http_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    struct http_state *hs = (struct http_state *)arg;
     if (!p) {
+        // Cliente fechou o lado dele (shutdown de escrita depois da requisição). Escrever
+        // em CLOSE_WAIT é válido: a resposta em andamento segue e http_sent fecha no último ACK
+        if (hs) {
+            return ERR_OK;
+        }
         tcp_close(tpcb);
         return ERR_OK;
     }
+    tcp_recved(tpcb, p->tot_len);
+    if (hs) {
+        // Uma requisição por conexão (Connection: close): o resto é ignorado
+        pbuf_free(p);
+        return ERR_OK;
+    }
 
-    char *req = (char *)p->payload;
-    struct http_state *hs = malloc(sizeof(struct http_state));
+    uint64_t inicio = time_us_64();
+    // A rota e os parâmetros saem de uma cópia terminada da linha de requisição: o payload
+    // não tem '\0' e a requisição pode vir em vários pbufs encadeados
+    char req[LINHA_REQUISICAO];
+    u16_t n = pbuf_copy_partial(p, req, sizeof(req) - 1, 0);
+    req[n] = '\0';
+    char *fim_linha = strpbrk(req, "\r\n");
+    if (fim_linha) {
+        *fim_linha = '\0';
+    }
+    RotaHttp rota = fim_linha || n == p->tot_len ? http_rota(req) : ROTA_INVALIDA;
+    hs = malloc(sizeof(struct http_state) + tamanho_resposta[rota]);
     if (!hs) {
+        http_falhas_alocacao++;
         pbuf_free(p);
         tcp_close(tpcb);
-        return ERR_MEM;
-    }
-    hs->sent = 0;
-
-    // JSON ultra compacto
-    if (strstr(req, "GET /d")) {
-        char json[128];
-        int json_len = snprintf(json, sizeof(json),
-                               "{\"t\":%.1f,\"h\":%.1f,\"p\":%.1f,\"a\":%.0f}",
-                               dados_sensores.temperatura_aht,
-                               dados_sensores.umidade,
-                               dados_sensores.pressao / 1000.0,
-                               dados_sensores.altitude);
-
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                          "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                          json_len, json);
-    } else if (strstr(req, "GET /set_config")) {
-        // Parsear e aplicar apenas offsets
-        char *ptr = strstr(req, "/set_config?");
-        if (ptr) {
-            ptr += strlen("/set_config?");
-            sscanf(ptr, "toff=%f&hoff=%f&poff=%f&aoff=%f",
-                   &offset_temp, &offset_humid, &offset_press, &offset_alt);
-            printf("Offsets recebidos: Temp:%.1f Umid:%.1f Pres:%.1f Alt:%.1f\n", offset_temp, offset_humid, offset_press, offset_alt);
+        return ERR_OK;
+    }
+    hs->enfileirado = 0;
+    hs->confirmado = 0;
+
+    // Tudo que vem do núcleo 1 é lido de uma cópia consistente
+    static Instantaneo snap;
+    char *corpo = hs->response + CABECALHO_RESPOSTA;
+    size_t tam_corpo = tamanho_resposta[rota] > CABECALHO_RESPOSTA ? tamanho_resposta[rota] - CABECALHO_RESPOSTA : 0;
+
+    switch (rota) {
+        // Histogramas e contadores de desempenho para o Prometheus
+        case ROTA_METRICS:
+            http_dinamica(hs, "text/plain; version=0.0.4", texto_metricas(corpo, tam_corpo), tam_corpo);
+            break;
+
+        // Estatísticas de janela (1 e 10 min) por canal
+        case ROTA_STATS:
+            ler_instantaneo(&snap);
+            http_dinamica(hs, "application/json", json_estatisticas(corpo, tam_corpo, &snap), tam_corpo);
+            break;
+
+        // Leituras individuais: /sensores lista todos, /sensores?id=N devolve um
+        case ROTA_SENSORES: {
+            ler_instantaneo(&snap);
+            int id = -1;
+            char *q = strstr(req, "/sensores?id=");
+            if (q) {
+                // Só dígitos até o fim do caminho: "-1", " 2", "1x" ou vazio não viram um id
+                const char *num = q + strlen("/sensores?id=");
+                char *fim;
+                unsigned long valor = strtoul(num, &fim, 10);
+                if (*num < '0' || *num > '9' || (*fim != ' ' && *fim != '&' && *fim != '\0')) {
+                    http_trechos(hs, RESPOSTA_400, sizeof(RESPOSTA_400) - 1, NULL, 0);
+                    break;
+                }
+                id = valor < snap.num_sensores ? (int)valor : (int)snap.num_sensores;
+            }
+            if (id >= (int)snap.num_sensores) {
+                http_trechos(hs, RESPOSTA_404, sizeof(RESPOSTA_404) - 1, NULL, 0);
+            } else {
+                http_dinamica(hs, "application/json", json_sensores(corpo, tam_corpo, id, &snap), tam_corpo);
+            }
+            break;
         }
 
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                          "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\nConnection: close\r\n\r\nOK");
-    }
-    else {
-        hs->len = snprintf(hs->response, sizeof(hs->response),
-                          "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %d\r\nConnection: close\r\n\r\n%s",
-                          (int)strlen(HTML_BODY), HTML_BODY);
+        // JSON ultra compacto
+        case ROTA_D: {
+            ler_instantaneo(&snap);
+            char t[12], h[12], pr[12], a[12];
+            fixo_formatar(t, sizeof(t), snap.dados.temperatura_aht, 2, 1);
+            fixo_formatar(h, sizeof(h), snap.dados.umidade, 2, 1);
+            fixo_formatar(pr, sizeof(pr), snap.dados.pressao, 3, 1);  // Pa -> kPa
+            fixo_formatar(a, sizeof(a), snap.dados.altitude, 1, 0);   // dm -> m
+            // s: bits OBSOLETO_* dos valores que pararam de ser atualizados
+            int json_len = snprintf(corpo, tam_corpo,
+                                   "{\"t\":%s,\"h\":%s,\"p\":%s,\"a\":%s,\"s\":%u}",
+                                   t, h, pr, a, snap.dados.obsoletos);
+            http_dinamica(hs, "application/json", json_len, tam_corpo);
+            break;
+        }
+
+        case ROTA_CONFIG: {
+            ler_instantaneo(&snap);
+            // Parsear e aplicar apenas offsets
+            char *ptr = strstr(req, "/set_config?");
+            if (ptr) {
+                ptr += strlen("/set_config?");
+                // Só os parâmetros presentes viram comandos; o núcleo 1 aplica e republica
+                int32_t ot = snap.offset_temp, oh = snap.offset_humid, op = snap.offset_press, oa = snap.offset_alt;
+                if (ler_parametro(ptr, "toff=", 2, &ot)) enviar_config(CFG_OFFSET_TEMP, ot);     // °C -> 0.01 °C
+                if (ler_parametro(ptr, "hoff=", 2, &oh)) enviar_config(CFG_OFFSET_UMID, oh);     // % -> 0.01 %
+                if (ler_parametro(ptr, "poff=", 0, &op)) enviar_config(CFG_OFFSET_PRESSAO, op);  // Pa
+                if (ler_parametro(ptr, "aoff=", 1, &oa)) enviar_config(CFG_OFFSET_ALT, oa);      // m -> dm
+
+                // Modo de agregação dos sensores redundantes: 0 média, 1 mediana, 2 voto
+                int32_t agr;
+                if (ler_parametro(ptr, "agr=", 0, &agr) && agr >= AGREGACAO_MEDIA && agr <= AGREGACAO_VOTO) {
+                    enviar_config(CFG_AGREGACAO, agr);
+                }
+
+                char sot[12], soh[12], soa[12];
+                fixo_formatar(sot, sizeof(sot), ot, 2, 1);
+                fixo_formatar(soh, sizeof(soh), oh, 2, 1);
+                fixo_formatar(soa, sizeof(soa), oa, 1, 1);
+                printf("Offsets recebidos: Temp:%s Umid:%s Pres:%ld Alt:%s\n", sot, soh, (long)op, soa);
+
+                // Pressão de referência ao nível do mar opcional (Pa), ex.: &p0=101800
+                int32_t p0_pa;
+                if (ler_parametro(ptr, "p0=", 0, &p0_pa) && p0_pa >= ALTITUDE_PRESSAO_MIN_PA &&
+                    p0_pa <= ALTITUDE_PRESSAO_MAX_PA) {
+                    enviar_config(CFG_REFERENCIA_P0, p0_pa);
+                    printf("Referencia ao nivel do mar: %ld Pa\n", (long)p0_pa);
+                }
+            }
+
+            http_trechos(hs, RESPOSTA_CONFIG_OK, sizeof(RESPOSTA_CONFIG_OK) - 1, NULL, 0);
+            break;
+        }
+
+        // Linha de requisição maior que LINHA_REQUISICAO
+        case ROTA_INVALIDA:
+            http_trechos(hs, RESPOSTA_400, sizeof(RESPOSTA_400) - 1, NULL, 0);
+            break;
+
+        case ROTA_PAGINA:
+            http_trechos(hs, cabecalho_pagina, tam_cabecalho_pagina, HTML_BODY, sizeof(HTML_BODY) - 1);
+            break;
     }
+    pbuf_free(p);
 
     tcp_arg(tpcb, hs);
     tcp_sent(tpcb, http_sent);
-    tcp_write(tpcb, hs->response, hs->len, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
-    pbuf_free(p);
+    tcp_poll(tpcb, http_poll, 2);
+    tcp_err(tpcb, http_err);
+    if (http_enviar(tpcb, hs) != ERR_OK) {
+        http_falhas_alocacao++;
+        return http_abortar(tpcb, hs);
+    }
+    http_requisicoes++;
+    histograma_registrar(&hist_http, (uint32_t)(time_us_64() - inicio));
     return ERR_OK;
 }
 
@@ -275,6 +935,11 @@ static err_t connection_callback(void *arg, struct tcp_pcb *newpcb, err_t err) {
 }
 
 void start_http_server(void) {
+    tam_cabecalho_pagina = snprintf(cabecalho_pagina, sizeof(cabecalho_pagina),
+                                    "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\nContent-Length: %u\r\n"
+                                    "Connection: close\r\n\r\n",
+                                    (unsigned)(sizeof(HTML_BODY) - 1));
+
     struct tcp_pcb *pcb = tcp_new();
     if (!pcb) {
         printf("Erro ao criar PCB TCP\n");
@@ -296,12 +961,11 @@ void init_hardware(void) {
     gpio_init(BOTAO_A);
     gpio_set_dir(BOTAO_A, GPIO_IN);
     gpio_pull_up(BOTAO_A);
-    gpio_set_irq_enabled_with_callback(BOTAO_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
     
     gpio_init(BOTAO_B);
     gpio_set_dir(BOTAO_B, GPIO_IN);
     gpio_pull_up(BOTAO_B);
-    gpio_set_irq_enabled_with_callback(BOTAO_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    // As interrupções dos botões são habilitadas no núcleo 1 (nucleo1_main)
     
     // Inicializar LEDs RGB
     gpio_init(LED_RGB_R);
@@ -311,19 +975,13 @@ void init_hardware(void) {
     gpio_set_dir(LED_RGB_G, GPIO_OUT);
     gpio_set_dir(LED_RGB_B, GPIO_OUT);
     
-    // Inicializar buzzer
-    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(BUZZER_PIN);
-    pwm_config config = pwm_get_default_config();
-    pwm_init(slice_num, &config, true);
-    pwm_set_gpio_level(BUZZER_PIN, 0);
-    
     // Inicializar matriz de LEDs
     uint offset = pio_add_program(pio, &ws2812_program);
     ws2812_program_init(pio, sm, offset, WS2812_PIN, 800000, false);
+    matriz_init(&matriz, pio, sm);
     
     // Inicializar display
-    i2c_init(I2C_PORT_DISP, 400 * 1000);
+    i2c_init(I2C_PORT_DISP, I2C_BAUDRATE);
     gpio_set_function(I2C_SDA_DISP, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL_DISP, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA_DISP);
@@ -331,36 +989,82 @@ void init_hardware(void) {
     
     ssd1306_init(&ssd, WIDTH, HEIGHT, false, ENDERECO_DISPLAY, I2C_PORT_DISP);
     ssd1306_config(&ssd);
+    telas_init(&telas, &ssd);
     ssd1306_fill(&ssd, false);
-    ssd1306_send_data(&ssd);
+    enviar_display();
 }
 
-void init_sensores(void) {
+void init_sensores(alarm_pool_t *pool) {
+#if SENSORES_SIMULADOS
+    static BackendSimulado simulado;
+    sensores = sensores_simulado_init(&simulado, &PERFIL_SIMULACAO, 1);
+    printf("Sensores simulados a %d Hz\n", TAXA_SIMULACAO_HZ);
+#else
     // Inicializar I2C para sensores
-    i2c_init(I2C_PORT, 400 * 1000);
+    i2c_init(I2C_PORT, I2C_BAUDRATE);
     gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
     gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
     gpio_pull_up(I2C_SDA);
     gpio_pull_up(I2C_SCL);
     
-    // Inicializar BMP280
-    bmp280_init(I2C_PORT);
+    // Todas as transações dos sensores passam pela fila com DMA. O barramento do
+    // display também ganha uma fila, por onde os quadros seguem por DMA (ssd1306_swap)
+    i2c_queue_init_dma(&fila_i2c, I2C_PORT, I2C_SDA, I2C_SCL, I2C_BAUDRATE);
+    i2c_queue_init_dma(&fila_i2c_disp, I2C_PORT_DISP, I2C_SDA_DISP, I2C_SCL_DISP, I2C_BAUDRATE);
+    ssd1306_attach_queue(&ssd, &fila_i2c_disp);
     
-    // Inicializar AHT20
-    aht20_reset(I2C_PORT);
-    aht20_init(I2C_PORT);
+    // Varre os dois barramentos e liga todo AHT20/BMP280 encontrado. Os BMP280 ficam
+    // em modo normal a BAROMETRO_TAXA_HZ, decimados para 1 Hz
+    i2c_queue_t *const barramentos[] = {&fila_i2c, &fila_i2c_disp};
+    uint8_t num = arranjo_iniciar(&arranjo, barramentos, count_of(barramentos), PERFIL_BMP280, MODO_AGREGACAO, pool);
+    for (uint8_t i = 0; i < num; i++) {
+        const SensorArranjo *s = &arranjo.sensores[i];
+        printf("Sensor %u: %s em i2c%u/0x%02X\n", i, s->tipo == SENSOR_AHT20 ? "AHT20" : "BMP280",
+               s->barramento, s->endereco);
+    }
+
+    static BackendReal real;
+    sensores = sensores_real_init(&real, &arranjo);
+#endif
+
+    altitude_definir_referencia(SEA_LEVEL_PRESSURE);
+
+    // Janelas medidas em tempo, já que a taxa de amostragem varia; limiares de espúria
+    // nas unidades internas
+    canal_estat_init(&canais[CANAL_TEMPERATURA], 200);  // 2 °C
+    canal_estat_init(&canais[CANAL_UMIDADE], 500);      // 5 %
+    canal_estat_init(&canais[CANAL_PRESSAO], 200);      // 200 Pa
+    canal_estat_init(&canais[CANAL_ALTITUDE], 200);     // 20 m
+
+    tendencia_init(&tendencia_temperatura, PERIODO_TENDENCIA_MS, PASSO_ESCALA_TEMP);
+    tendencia_init(&tendencia_pressao, PERIODO_TENDENCIA_MS, PASSO_ESCALA_PRESSAO);
+
+    static const ConfigAdaptativo cfg_adaptativo = {
+        .num_canais = NUM_CANAIS,
+        .limiar_por_min = {
+            [CANAL_TEMPERATURA] = LIMIAR_DERIVADA_TEMP,
+            [CANAL_UMIDADE] = LIMIAR_DERIVADA_UMID,
+            [CANAL_PRESSAO] = LIMIAR_DERIVADA_PRESSAO,
+            [CANAL_ALTITUDE] = 0,   // só espelha a pressão
+        },
+        .base_ms = BASE_DERIVADA_MS,
+        .espera_ms = ESPERA_RECUO_MS,
+        .num_niveis = count_of(niveis_amostragem),
+        .nivel_inicial = NIVEL_AMOSTRAGEM_INICIAL,
+    };
+    adaptativo_init(&adaptativo, &cfg_adaptativo, to_ms_since_boot(get_absolute_time()));
 }
 
 void init_wifi(void) {
     ssd1306_fill(&ssd, false);
     ssd1306_draw_string(&ssd, "Iniciando Wi-Fi", 0, 0);
     ssd1306_draw_string(&ssd, "Aguarde...", 0, 20);
-    ssd1306_send_data(&ssd);
+    enviar_display();
     
     if (cyw43_arch_init()) {
         ssd1306_fill(&ssd, false);
         ssd1306_draw_string(&ssd, "WiFi => FALHA", 0, 0);
-        ssd1306_send_data(&ssd);
+        enviar_display();
         dados_sensores.wifi_conectado = false;
         return;
     }
@@ -369,7 +1073,7 @@ void init_wifi(void) {
     if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASS, CYW43_AUTH_WPA2_AES_PSK, 10000)) {
         ssd1306_fill(&ssd, false);
         ssd1306_draw_string(&ssd, "WiFi => ERRO", 0, 0);
-        ssd1306_send_data(&ssd);
+        enviar_display();
         dados_sensores.wifi_conectado = false;
         return;
     }
@@ -381,89 +1085,110 @@ void init_wifi(void) {
     ssd1306_fill(&ssd, false);
     ssd1306_draw_string(&ssd, "WiFi => OK", 0, 0);
     ssd1306_draw_string(&ssd, ip_str, 0, 20);
-    ssd1306_send_data(&ssd);
+    enviar_display();
     
     start_http_server();
     sleep_ms(2000);
 }
 
-void ler_sensores(void) {
-    // Ler BMP280
-    struct bmp280_calib_param params;
-    bmp280_get_calib_params(I2C_PORT, &params);
-    
-    int32_t raw_temp_bmp, raw_pressure;
-    bmp280_read_raw(I2C_PORT, &raw_temp_bmp, &raw_pressure);
-    
-    int32_t temperature = bmp280_convert_temp(raw_temp_bmp, &params);
-    int32_t pressure = bmp280_convert_pressure(raw_pressure, raw_temp_bmp, &params);
-    
-    float temp_bmp = temperature / 100.0;
-    dados_sensores.pressao = pressure + offset_press; // Aplicar offset de pressão
-    dados_sensores.altitude = 44330.0 * (1.0 - pow(dados_sensores.pressao / SEA_LEVEL_PRESSURE, 0.1903)) + offset_alt; // Aplicar offset de altitude
-    
-    // Ler AHT20
-    AHT20_Data data;
-    if (aht20_read(I2C_PORT, &data)) {
-        // Calcular média das temperaturas e aplicar offset
-        dados_sensores.temperatura_aht = ((data.temperature + temp_bmp) / 2.0) + offset_temp;
-        dados_sensores.temperatura_bmp = temp_bmp; // Manter para referência
-        dados_sensores.umidade = data.humidity + offset_humid; // Aplicar offset de umidade
+// Aplica um novo nível de amostragem ao disparo do AHT20 e à taxa/decimação do BMP280.
+// Com sensores simulados a taxa fica fixa em TAXA_SIMULACAO_HZ.
+static void aplicar_nivel_amostragem(uint8_t nivel) {
+#if !SENSORES_SIMULADOS
+    periodo_amostragem_ms = niveis_amostragem[nivel].periodo_ms;
+    agendador_definir_periodo(&agendador, tarefa_amostragem, periodo_amostragem_ms * 1000);
+    barometro_definir_taxa(&arranjo.barometro, niveis_amostragem[nivel].taxa_barometro_hz, periodo_amostragem_ms);
+    printf("Amostragem: %lu ms (%s)\n", (unsigned long)periodo_amostragem_ms,
+           adaptativo_nome_motivo(adaptativo.motivo));
+#else
+    (void)nivel;
+#endif
+}
+
+void processar_barometro(const LeituraBarometro *leitura) {
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    dados_sensores.temperatura_bmp = leitura->temperatura;
+    barometro_lido = true;
+    // Offsets aplicados antes do filtro de mediana, que descarta leituras espúrias
+    dados_sensores.pressao = canal_estat_atualizar(&canais[CANAL_PRESSAO], (int32_t)leitura->pressao + offset_press,
+                                                   agora);
+    dados_sensores.altitude = canal_estat_atualizar(&canais[CANAL_ALTITUDE],
+                                                    altitude_calcular_dm((uint32_t)dados_sensores.pressao) + offset_alt,
+                                                    agora);
+    ultimo_barometro_ms = agora;
+    tendencia_adicionar(&tendencia_pressao, dados_sensores.pressao, agora);
+    if (adaptativo_atualizar(&adaptativo, CANAL_PRESSAO, dados_sensores.pressao, agora)) {
+        aplicar_nivel_amostragem(adaptativo_nivel(&adaptativo));
+    }
+
+    // Extremos sem filtro: são justamente os picos que a mediana descarta
+    janela_pressao.min = (int32_t)leitura->pressao_min + offset_press;
+    janela_pressao.max = (int32_t)leitura->pressao_max + offset_press;
+    uint32_t amplitude = leitura->pressao_max - leitura->pressao_min;
+    if (amplitude >= LIMIAR_TRANSIENTE_PA) {
+        janela_pressao.transientes++;
+        janela_pressao.ultimo_pa = amplitude;
+        janela_pressao.ultimo_ms = agora;
     }
 }
 
-void atualizar_display(void) {
-    ssd1306_fill(&ssd, false);
-    
-    if (tela_atual == TELA_SENSORES) {
-        char str_temp[10], str_umid[10], str_press[10], str_alt[10];
-        char header[20];
-        
-        snprintf(str_temp, sizeof(str_temp), "%.1fC", dados_sensores.temperatura_aht);
-        snprintf(str_umid, sizeof(str_umid), "%.1f%%", dados_sensores.umidade);
-        snprintf(str_press, sizeof(str_press), "%.1fkPa", dados_sensores.pressao / 1000.0);
-        snprintf(str_alt, sizeof(str_alt), "%.0fm", dados_sensores.altitude);
-        snprintf(header, sizeof(header), "-> %s", nomes_status[status_atual]);
-        
-        ssd1306_rect(&ssd, 2, 2, 124, 60, true, false);
-        ssd1306_draw_string(&ssd, header, 4, 5);
-        ssd1306_line(&ssd, 2, 15, 126, 15, true);
-        
-        ssd1306_draw_string(&ssd, "Temp: ", 4, 20);
-        ssd1306_draw_string(&ssd, str_temp, 45, 20);
-        
-        ssd1306_draw_string(&ssd, "Umid: ", 4, 30);
-        ssd1306_draw_string(&ssd, str_umid, 45, 30);
-        
-        ssd1306_draw_string(&ssd, "Pres: ", 4, 40);
-        ssd1306_draw_string(&ssd, str_press, 45, 40);
-        
-        ssd1306_draw_string(&ssd, "Alt: ", 4, 50);
-        ssd1306_draw_string(&ssd, str_alt, 35, 50);
-        
-    } else { // TELA_WIFI
-        ssd1306_rect(&ssd, 2, 2, 124, 60, true, false);
-        ssd1306_draw_string(&ssd, "STATUS CONEXAO", 10, 5);
-        ssd1306_line(&ssd, 2, 15, 126, 15, true);
-        
-        if (dados_sensores.wifi_conectado) {
-            ssd1306_draw_string(&ssd, "WiFi: CONECTADO", 4, 20);
-            ssd1306_draw_string(&ssd, "IP:", 4, 30);
-            ssd1306_draw_string(&ssd, ip_str, 4, 40);
-            ssd1306_draw_string(&ssd, "Porta: 80", 4, 50);
-        } else {
-            ssd1306_draw_string(&ssd, "WiFi: DESCONECT.", 4, 25);
-            ssd1306_draw_string(&ssd, "Verifique config", 4, 40);
+void processar_amostra(const AmostraSensores *amostra) {
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    // AHT20
+    if (amostra->aht_ok) {
+        // Média com o BMP280 só enquanto ele tem leitura recente: sem barômetro no arranjo,
+        // ainda sem a primeira leitura decimada ou com ele parado, vale só o AHT20
+        int32_t temperatura = amostra->aht.temperature;
+        if (barometro_lido && agora - ultimo_barometro_ms <= VALIDADE_DADOS_MS) {
+            temperatura = (temperatura + dados_sensores.temperatura_bmp) / 2;
+        }
+        temperatura += offset_temp;
+        dados_sensores.temperatura_aht = canal_estat_atualizar(&canais[CANAL_TEMPERATURA], temperatura, agora);
+        dados_sensores.umidade = canal_estat_atualizar(&canais[CANAL_UMIDADE], amostra->aht.humidity + offset_humid,
+                                                       agora);
+        ultima_amostra_ms = agora;
+        tendencia_adicionar(&tendencia_temperatura, dados_sensores.temperatura_aht, agora);
+        bool mudou = adaptativo_atualizar(&adaptativo, CANAL_TEMPERATURA, dados_sensores.temperatura_aht, agora);
+        mudou |= adaptativo_atualizar(&adaptativo, CANAL_UMIDADE, dados_sensores.umidade, agora);
+        if (mudou) {
+            aplicar_nivel_amostragem(adaptativo_nivel(&adaptativo));
         }
     }
-    
-    ssd1306_send_data(&ssd);
+}
+
+// Depois de init_sensores o display é mais um cliente da fila do i2c1: o quadro segue
+// por DMA em segundo plano e aqui só se mede a montagem. Antes disso (telas do Wi-Fi)
+// o envio é bloqueante
+void enviar_display(void) {
+    uint64_t inicio = time_us_64();
+    bool ok = ssd1306_send_data(&ssd);
+    histograma_registrar(&hist_envio_display, (uint32_t)(time_us_64() - inicio));
+    if (!ok && !ssd.queue) {
+        falhas_display++;
+        ssd1306_invalidate(&ssd);
+    }
+}
+
+void atualizar_display(void) {
+    DadosTela d = {
+        .temperatura = dados_sensores.temperatura_aht,
+        .umidade = dados_sensores.umidade,
+        .pressao = dados_sensores.pressao,
+        .altitude = dados_sensores.altitude,
+        .temp_umid_obsoletas = dados_sensores.obsoletos & OBSOLETO_TEMP_UMID,
+        .pressao_obsoleta = dados_sensores.obsoletos & OBSOLETO_PRESSAO,
+        .wifi_conectado = dados_sensores.wifi_conectado,
+        .ip = ip_str,
+        .status = nomes_status[status_atual],
+        .tendencia_temperatura = &tendencia_temperatura,
+        .tendencia_pressao = &tendencia_pressao,
+    };
+    telas_desenhar(&telas, tela_atual, &d);
+    enviar_display();
 }
 
 void atualizar_matriz_leds(void) {
     NivelStatus nivel;
-    const bool *padrao;
-    uint8_t r, g, b;
     
     switch (status_atual) {
         case STATUS_TEMPERATURA:
@@ -477,27 +1202,29 @@ void atualizar_matriz_leds(void) {
             break;
         case STATUS_ALTITUDE:
             // Usando limites fixos para altitude também
-            nivel = (dados_sensores.altitude > 1000) ? NIVEL_CRITICO : 
-                   (dados_sensores.altitude > 500) ? NIVEL_ALERTA : NIVEL_BOM;
+            nivel = (dados_sensores.altitude > 10000) ? NIVEL_CRITICO :   // 1000 m
+                   (dados_sensores.altitude > 5000) ? NIVEL_ALERTA : NIVEL_BOM; // 500 m
             break;
     }
     
-    switch (nivel) {
-        case NIVEL_BOM:
-            padrao = padrao_bom;
-            r = 0; g = 10; b = 0;
-            break;
-        case NIVEL_ALERTA:
-            padrao = padrao_alerta;
-            r = 10; g = 5; b = 0;
-            break;
-        case NIVEL_CRITICO:
-            padrao = padrao_critico;
-            r = 10; g = 0; b = 0;
-            break;
-    }
-    
-    display_matriz(padrao, r, g, b);
+    // A animação roda no alarme; mudar de nível só troca a sequência (com transição)
+    animacao_tocar(&animacao, &sequencias_nivel[nivel]);
+}
+
+// Barra com a posição do valor da grandeza selecionada na faixa dela
+void mostrar_barra_status(void) {
+    int32_t valores[] = {
+        [STATUS_TEMPERATURA] = dados_sensores.temperatura_aht,
+        [STATUS_UMIDADE] = dados_sensores.umidade,
+        [STATUS_PRESSAO] = dados_sensores.pressao,
+        [STATUS_ALTITUDE] = dados_sensores.altitude,
+    };
+    int32_t v = valores[status_atual];
+    int32_t min = faixas_barra[status_atual].min, max = faixas_barra[status_atual].max;
+    if (v < min) v = min;
+    if (v > max) v = max;
+    uint8_t acesos = (uint8_t)((v - min) * MATRIZ_PIXELS / (max - min));
+    animacao_barra(&animacao, acesos, faixas_barra[status_atual].cor, DURACAO_BARRA_MS);
 }
 
 void atualizar_led_rgb(void) {
@@ -520,58 +1247,170 @@ void verificar_alertas(void) {
     if ((agora - ultimo_alerta) < 5000) return;
     
     // Usando limites fixos para alertas
-    bool alerta_temperatura = (dados_sensores.temperatura_aht < 10 || dados_sensores.temperatura_aht > 35);
-    bool alerta_umidade = (dados_sensores.umidade < 30 || dados_sensores.umidade > 80);
+    bool alerta_temperatura = (dados_sensores.temperatura_aht < 1000 || dados_sensores.temperatura_aht > 3500);
+    bool alerta_umidade = (dados_sensores.umidade < 3000 || dados_sensores.umidade > 8000);
     
     if (alerta_temperatura || alerta_umidade) {
-        play_sound(800, 200);
-        sleep_ms(100);
-        play_sound(1000, 200);
+        buzzer_tocar(&buzzer, &som_alerta, SOM_ALERTA);
         ultimo_alerta = agora;
     }
 }
 
+// --- Tarefas ---
+
+static void tarefa_botoes_fn(void *ctx) {
+    if (botao_a_pressionado) {
+        botao_a_pressionado = false;
+        status_atual = (status_atual + 1) % 4;
+        mostrar_barra_status();
+        buzzer_tocar(&buzzer, &som_botao_a, SOM_CLIQUE);
+    }
+    
+    if (botao_b_pressionado) {
+        botao_b_pressionado = false;
+        tela_atual = (tela_atual + 1) % NUM_TELAS;
+        buzzer_tocar(&buzzer, &som_botao_b, SOM_CLIQUE);
+    }
+    
+    // Resposta imediata na tela, sem esperar o próximo período do display
+    agendador_sinalizar(&agendador, tarefa_display);
+}
+
+// Dispara as conversões; o resultado é recolhido pela tarefa de coleta
+static void tarefa_amostragem_fn(void *ctx) {
+    sensores->disparar(sensores);
+}
+
+static void tarefa_coleta_fn(void *ctx) {
+    // Consumir as amostras do BMP280 acumuladas em segundo plano
+    bool nova = false;
+    LeituraBarometro leitura_baro;
+    if (sensores->coletar_barometro(sensores, &leitura_baro)) {
+        processar_barometro(&leitura_baro);
+        nova = true;
+    }
+    
+    AmostraSensores amostra;
+    if (sensores->coletar(sensores, &amostra)) {
+        processar_amostra(&amostra);
+        nova = true;
+    }
+    
+    // Sem leitura boa recente o valor fica retido, mas marcado como obsoleto
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+    uint8_t obsoletos = 0;
+    if (agora - ultima_amostra_ms > VALIDADE_DADOS_MS) obsoletos |= OBSOLETO_TEMP_UMID;
+    if (agora - ultimo_barometro_ms > VALIDADE_DADOS_MS) obsoletos |= OBSOLETO_PRESSAO;
+    if (obsoletos != dados_sensores.obsoletos) {
+        dados_sensores.obsoletos = obsoletos;
+        nova = true;
+    }
+    
+    if (nova) {
+        publicar_instantaneo();
+    }
+}
+
+static void tarefa_display_fn(void *ctx) {
+    atualizar_display();
+}
+
+static void tarefa_leds_fn(void *ctx) {
+    atualizar_matriz_leds();
+    atualizar_led_rgb();
+}
+
+static void tarefa_alertas_fn(void *ctx) {
+    verificar_alertas();
+}
+
+// Troca de offset: filtro, janelas, gráfico e referência da taxa adaptativa andam junto,
+// senão o degrau parece uma variação real do canal e força a taxa mais rápida
+static void deslocar_canal(IdCanal canal, Tendencia *t, int32_t delta) {
+    canal_estat_deslocar(&canais[canal], delta);
+    adaptativo_deslocar(&adaptativo, canal, delta);
+    if (t) {
+        tendencia_deslocar(t, delta);
+    }
+}
+
+// Aplica os comandos de configuração que chegaram do núcleo 0
+static void tarefa_config_fn(void *ctx) {
+    while (fila_config_tail != fila_config_head) {
+        uint32_t palavra = fila_config[fila_config_tail % FILA_CONFIG];
+        fila_config_tail++;
+        int32_t valor = (int32_t)(palavra << 4) >> 4;  // estende o sinal dos 28 bits
+
+        switch ((ComandoConfig)(palavra >> 28)) {
+            case CFG_OFFSET_TEMP:
+                deslocar_canal(CANAL_TEMPERATURA, &tendencia_temperatura, valor - offset_temp);
+                offset_temp = valor;
+                break;
+            case CFG_OFFSET_UMID:
+                deslocar_canal(CANAL_UMIDADE, NULL, valor - offset_humid);
+                offset_humid = valor;
+                break;
+            case CFG_OFFSET_PRESSAO:
+                deslocar_canal(CANAL_PRESSAO, &tendencia_pressao, valor - offset_press);
+                offset_press = valor;
+                break;
+            case CFG_OFFSET_ALT:
+                deslocar_canal(CANAL_ALTITUDE, NULL, valor - offset_alt);
+                offset_alt = valor;
+                break;
+            case CFG_REFERENCIA_P0:  altitude_definir_referencia((uint32_t)valor); break;
+            case CFG_AGREGACAO:      arranjo.modo = (ModoAgregacao)valor; break;
+        }
+    }
+    publicar_instantaneo();
+}
+
+// Núcleo 1: aquisição, filtragem, display, LEDs e alertas. Alarmes, interrupções de
+// I2C, GPIO e FIFO são registrados aqui para rodarem neste núcleo.
+static void nucleo1_main(void) {
+    alarm_pool_t *pool = alarm_pool_create_with_unused_hardware_alarm(AGENDADOR_MAX_TAREFAS + 3);
+    
+    init_sensores(pool);
+    buzzer_init(&buzzer, BUZZER_PIN, pool);
+    animacao_init(&animacao, &matriz, pool);
+    
+    agendador_init(&agendador, pool);
+    tarefa_botoes = agendador_criar(&agendador, "botoes", tarefa_botoes_fn, NULL, 0, PRAZO_BOTOES_MS * 1000);
+    tarefa_display = agendador_criar(&agendador, "display", tarefa_display_fn, NULL,
+                                     PERIODO_DISPLAY_MS * 1000, PRAZO_DISPLAY_MS * 1000);
+    tarefa_config = agendador_criar(&agendador, "config", tarefa_config_fn, NULL, 0, PRAZO_CONFIG_MS * 1000);
+    tarefa_amostragem = agendador_criar(&agendador, "amostragem", tarefa_amostragem_fn, NULL,
+                                        PERIODO_AMOSTRAGEM_MS * 1000, 0);
+    agendador_criar(&agendador, "coleta", tarefa_coleta_fn, NULL, PERIODO_COLETA_MS * 1000, 0);
+    agendador_criar(&agendador, "leds", tarefa_leds_fn, NULL, PERIODO_LEDS_MS * 1000, PRAZO_LEDS_MS * 1000);
+    agendador_criar(&agendador, "alertas", tarefa_alertas_fn, NULL, PERIODO_ALERTAS_MS * 1000, 0);
+    publicar_instantaneo();
+    
+    gpio_set_irq_enabled_with_callback(BOTAO_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    gpio_set_irq_enabled_with_callback(BOTAO_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    
+    multicore_fifo_drain();
+    multicore_fifo_clear_irq();
+    irq_set_exclusive_handler(SIO_IRQ_PROC1, fifo_irq_handler);
+    irq_set_enabled(SIO_IRQ_PROC1, true);
+    
+    agendador_executar(&agendador);
+}
+
+// Núcleo 0: só cyw43/lwIP, para a latência HTTP não depender de I2C nem do display
 int main(void) {
     init_hardware();
     sleep_ms(1000);
     
-    init_sensores();
+    // O Wi-Fi usa o display para mostrar o progresso; depois dele o display é do núcleo 1
     init_wifi();
+    multicore_launch_core1(nucleo1_main);
     
-    uint32_t ultimo_update = 0;
-    
+    // Com pico_cyw43_arch_lwip_threadsafe_background o cyw43 e o lwIP (e com eles o
+    // servidor HTTP) rodam na interrupção do chip: não há nada para consultar aqui, o
+    // núcleo 0 só dorme até a próxima interrupção
     while (true) {
-        uint32_t agora = to_ms_since_boot(get_absolute_time());
-        
-        // Processar botões
-        if (botao_a_pressionado) {
-            botao_a_pressionado = false;
-            status_atual = (status_atual + 1) % 4;
-            play_sound(1200, 100);
-        }
-        
-        if (botao_b_pressionado) {
-            botao_b_pressionado = false;
-            tela_atual = (tela_atual == TELA_SENSORES) ? TELA_WIFI : TELA_SENSORES;
-            play_sound(800, 100);
-        }
-        
-        // Atualizar sensores e displays a cada 1 segundo
-        if ((agora - ultimo_update) >= 1000) {
-            ler_sensores();
-            atualizar_display();
-            atualizar_matriz_leds();
-            atualizar_led_rgb();
-            verificar_alertas();
-            ultimo_update = agora;
-        }
-        
-        // Processar requisições web
-        if (dados_sensores.wifi_conectado) {
-            cyw43_arch_poll();
-        }
-        
-        sleep_ms(50);
+        __wfe();
     }
     
     return 0;
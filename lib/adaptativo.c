@@ -0,0 +1,86 @@
+#include "adaptativo.h"
+
+void adaptativo_init(Adaptativo *a, const ConfigAdaptativo *cfg, uint32_t t_ms) {
+    a->cfg = *cfg;
+    if (a->cfg.num_canais > ADAPT_MAX_CANAIS) {
+        a->cfg.num_canais = ADAPT_MAX_CANAIS;
+    }
+    for (uint8_t i = 0; i < ADAPT_MAX_CANAIS; i++) {
+        a->tem_referencia[i] = false;
+        a->derivada[i] = 0;
+    }
+    a->nivel = cfg->nivel_inicial < cfg->num_niveis ? cfg->nivel_inicial : cfg->num_niveis - 1;
+    a->motivo = MOTIVO_INICIO;
+    a->canal_motivo = 0;
+    a->ultimo_evento_ms = t_ms;
+    a->trocas = 0;
+}
+
+// Desce um nível (mais lento) depois de espera_ms sem disparos
+bool adaptativo_verificar(Adaptativo *a, uint32_t t_ms) {
+    if (a->nivel + 1 >= a->cfg.num_niveis || t_ms - a->ultimo_evento_ms < a->cfg.espera_ms) {
+        return false;
+    }
+    a->nivel++;
+    a->motivo = MOTIVO_ESTAVEL;
+    a->ultimo_evento_ms = t_ms;
+    a->trocas++;
+    return true;
+}
+
+bool adaptativo_atualizar(Adaptativo *a, uint8_t canal, int32_t valor, uint32_t t_ms) {
+    if (canal >= a->cfg.num_canais || a->cfg.limiar_por_min[canal] <= 0) {
+        return adaptativo_verificar(a, t_ms);
+    }
+
+    if (!a->tem_referencia[canal]) {
+        a->tem_referencia[canal] = true;
+        a->referencia[canal] = valor;
+        a->referencia_ms[canal] = t_ms;
+        return adaptativo_verificar(a, t_ms);
+    }
+
+    // Variação desde a referência, escalada para unidades/min. Abaixo da base o
+    // divisor é a própria base: um degrau rápido dispara assim que alcança o que o
+    // limiar permitiria na base inteira, sem amplificar o ruído de quantização.
+    uint32_t decorrido = t_ms - a->referencia_ms[canal];
+    uint32_t divisor = decorrido > a->cfg.base_ms ? decorrido : a->cfg.base_ms;
+    int64_t delta = (int64_t)valor - a->referencia[canal];
+    int32_t derivada = (int32_t)(delta * 60000 / (int64_t)divisor);
+    a->derivada[canal] = derivada;
+
+    if (decorrido >= a->cfg.base_ms) {
+        a->referencia[canal] = valor;
+        a->referencia_ms[canal] = t_ms;
+    }
+
+    int32_t limiar = a->cfg.limiar_por_min[canal];
+    if (derivada > limiar || -derivada > limiar) {
+        bool mudou = a->nivel != 0;
+        a->nivel = 0;
+        a->motivo = MOTIVO_VARIACAO;
+        a->canal_motivo = canal;
+        a->ultimo_evento_ms = t_ms;
+        if (mudou) {
+            a->trocas++;
+        }
+        return mudou;
+    }
+
+    return adaptativo_verificar(a, t_ms);
+}
+
+void adaptativo_deslocar(Adaptativo *a, uint8_t canal, int32_t delta) {
+    if (canal < a->cfg.num_canais && a->tem_referencia[canal]) {
+        a->referencia[canal] += delta;
+    }
+}
+
+const char *adaptativo_nome_motivo(MotivoTaxa motivo) {
+    switch (motivo) {
+        case MOTIVO_VARIACAO: return "variacao";
+        case MOTIVO_ESTAVEL:  return "estavel";
+        case MOTIVO_INICIO:
+        default:              return "inicio";
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef ADAPTATIVO_H
+#define ADAPTATIVO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Controlador da taxa de amostragem guiado pela derivada dos canais. Não depende do
+// SDK: pode ser alimentado no host com séries gravadas ou sintéticas (simulador.h).
+
+#define ADAPT_MAX_CANAIS 4
+
+typedef enum {
+    MOTIVO_INICIO,     // nível inicial, ainda sem histórico
+    MOTIVO_VARIACAO,   // algum canal passou do limiar de derivada
+    MOTIVO_ESTAVEL     // tudo abaixo do limiar por tempo suficiente: desacelera
+} MotivoTaxa;
+
+typedef struct {
+    uint8_t num_canais;
+    // Limiar de derivada por canal, em unidades do canal por minuto (0 = canal ignorado)
+    int32_t limiar_por_min[ADAPT_MAX_CANAIS];
+    // Base de tempo da derivada: variações mais rápidas que isso contam pela base inteira
+    uint32_t base_ms;
+    // Tempo sem disparos até descer um nível de taxa
+    uint32_t espera_ms;
+    // Níveis de taxa: 0 é o mais rápido, num_niveis-1 o mais lento
+    uint8_t num_niveis;
+    uint8_t nivel_inicial;
+} ConfigAdaptativo;
+
+typedef struct {
+    ConfigAdaptativo cfg;
+
+    // Ponto de referência e derivada estimada por canal
+    bool tem_referencia[ADAPT_MAX_CANAIS];
+    int32_t referencia[ADAPT_MAX_CANAIS];
+    uint32_t referencia_ms[ADAPT_MAX_CANAIS];
+    int32_t derivada[ADAPT_MAX_CANAIS];   // unidades por minuto
+
+    uint8_t nivel;
+    MotivoTaxa motivo;
+    uint8_t canal_motivo;      // canal que disparou a última aceleração
+    uint32_t ultimo_evento_ms; // último disparo ou última troca de nível
+    uint32_t trocas;
+} Adaptativo;
+
+void adaptativo_init(Adaptativo *a, const ConfigAdaptativo *cfg, uint32_t t_ms);
+
+// Alimenta uma amostra (já filtrada) do canal colhida em t_ms.
+// Retorna true quando o nível de taxa mudou.
+bool adaptativo_atualizar(Adaptativo *a, uint8_t canal, int32_t valor, uint32_t t_ms);
+
+// Soma delta à referência do canal: uma troca de offset não conta como variação
+void adaptativo_deslocar(Adaptativo *a, uint8_t canal, int32_t delta);
+
+// Reavalia o recuo por estabilidade sem uma amostra nova (ex.: canal parado)
+bool adaptativo_verificar(Adaptativo *a, uint32_t t_ms);
+
+static inline uint8_t adaptativo_nivel(const Adaptativo *a) {
+    return a->nivel;
+}
+
+const char *adaptativo_nome_motivo(MotivoTaxa motivo);
+
+#endif // ADAPTATIVO_H
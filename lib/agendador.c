@@ -0,0 +1,182 @@
+#include "agendador.h"
+#include "hardware/sync.h"
+
+// Roda em interrupção (alarme ou GPIO)
+static void agendador_liberar(Tarefa *t, uint64_t instante_us) {
+    Agendador *ag = t->dono;
+    uint32_t bit = 1u << t->id;
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (ag->prontas & bit) {
+        t->perdidas++;  // a ativação pendente absorve esta
+    } else {
+        t->liberada_us = instante_us;
+        ag->prontas |= bit;
+    }
+    restore_interrupts(irq);
+
+    // Acorda o laço principal se ele estiver em __wfe()
+    __sev();
+}
+
+static int64_t agendador_alarme_periodico(alarm_id_t id, void *user) {
+    Tarefa *t = (Tarefa *)user;
+    agendador_liberar(t, t->proxima_us);
+    t->proxima_us += t->periodo_us;
+    // Negativo: reagenda a partir do disparo nominal anterior, sem acumular deriva
+    return -(int64_t)t->periodo_us;
+}
+
+static int64_t agendador_alarme_unico(alarm_id_t id, void *user) {
+    Tarefa *t = (Tarefa *)user;
+    t->alarme = 0;
+    agendador_liberar(t, t->proxima_us);
+    return 0;
+}
+
+void agendador_init(Agendador *ag, alarm_pool_t *pool) {
+    ag->pool = pool ? pool : alarm_pool_get_default();
+    ag->num_tarefas = 0;
+    ag->prontas = 0;
+    ag->ocioso_us = 0;
+    ag->janela_inicio_us = time_us_64();
+    ag->janela_ocioso_us = 0;
+    ag->ocioso_ms = 0;
+    ag->ocioso_permil = 0;
+}
+
+int agendador_criar(Agendador *ag, const char *nome, FuncaoTarefa funcao, void *ctx,
+                    uint32_t periodo_us, uint32_t prazo_us) {
+    if (ag->num_tarefas >= AGENDADOR_MAX_TAREFAS) {
+        return -1;
+    }
+
+    Tarefa *t = &ag->tarefas[ag->num_tarefas];
+    *t = (Tarefa){0};
+    t->nome = nome;
+    t->funcao = funcao;
+    t->ctx = ctx;
+    t->periodo_us = periodo_us;
+    t->prazo_us = prazo_us ? prazo_us : periodo_us;
+    t->dono = ag;
+    t->id = ag->num_tarefas;
+
+    if (periodo_us) {
+        t->proxima_us = time_us_64() + periodo_us;
+        t->alarme = alarm_pool_add_alarm_at(ag->pool, t->proxima_us, agendador_alarme_periodico, t, true);
+        if (t->alarme < 0) {
+            return -1;
+        }
+    }
+    return ag->num_tarefas++;
+}
+
+void agendador_sinalizar(Agendador *ag, int id) {
+    if (id >= 0 && id < ag->num_tarefas) {
+        agendador_liberar(&ag->tarefas[id], time_us_64());
+    }
+}
+
+bool agendador_disparar_em(Agendador *ag, int id, uint32_t atraso_us) {
+    if (id < 0 || id >= ag->num_tarefas) {
+        return false;
+    }
+    Tarefa *t = &ag->tarefas[id];
+    if (t->periodo_us || t->alarme > 0) {
+        return false;  // periódica, ou já há um disparo armado
+    }
+    t->proxima_us = time_us_64() + atraso_us;
+    t->alarme = alarm_pool_add_alarm_at(ag->pool, t->proxima_us, agendador_alarme_unico, t, true);
+    return t->alarme >= 0;
+}
+
+void agendador_definir_periodo(Agendador *ag, int id, uint32_t periodo_us) {
+    if (id < 0 || id >= ag->num_tarefas || periodo_us == 0) {
+        return;
+    }
+    Tarefa *t = &ag->tarefas[id];
+    if (!t->periodo_us || t->periodo_us == periodo_us) {
+        return;
+    }
+
+    // O alarme roda neste núcleo: com as interrupções desligadas ele não está no meio do callback
+    uint32_t irq = save_and_disable_interrupts();
+    alarm_pool_cancel_alarm(ag->pool, t->alarme);
+    if (t->prazo_us == t->periodo_us) {
+        t->prazo_us = periodo_us;
+    }
+    t->periodo_us = periodo_us;
+    t->proxima_us = time_us_64() + periodo_us;
+    t->alarme = alarm_pool_add_alarm_at(ag->pool, t->proxima_us, agendador_alarme_periodico, t, true);
+    restore_interrupts(irq);
+}
+
+bool agendador_executar_uma(Agendador *ag) {
+    // Escolhe pelo prazo absoluto (EDF); com poucas tarefas a varredura linear basta
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t prontas = ag->prontas;
+    Tarefa *escolhida = NULL;
+    uint64_t menor_prazo = UINT64_MAX;
+    for (uint8_t i = 0; prontas; i++, prontas >>= 1) {
+        if (prontas & 1) {
+            Tarefa *t = &ag->tarefas[i];
+            uint64_t prazo = t->liberada_us + t->prazo_us;
+            if (prazo < menor_prazo) {
+                menor_prazo = prazo;
+                escolhida = t;
+            }
+        }
+    }
+    if (escolhida) {
+        ag->prontas &= ~(1u << escolhida->id);
+    }
+    restore_interrupts(irq);
+
+    if (!escolhida) {
+        return false;
+    }
+
+    Tarefa *t = escolhida;
+    uint64_t inicio = time_us_64();
+    uint32_t jitter = inicio > t->liberada_us ? (uint32_t)(inicio - t->liberada_us) : 0;
+    t->funcao(t->ctx);
+    uint64_t fim = time_us_64();
+
+    uint32_t duracao = (uint32_t)(fim - inicio);
+    t->execucoes++;
+    t->jitter_ultimo_us = jitter;
+    t->jitter_soma_us += jitter;
+    if (jitter > t->jitter_max_us) t->jitter_max_us = jitter;
+    if (duracao > t->duracao_max_us) t->duracao_max_us = duracao;
+    histograma_registrar(&t->duracao, duracao);
+    if (fim > menor_prazo) {
+        t->overruns++;
+    }
+    return true;
+}
+
+// Fecha a janela de ocupação quando ela completa AGENDADOR_JANELA_OCIOSO_US
+static void agendador_contabilizar(Agendador *ag, uint64_t agora) {
+    uint64_t decorrido = agora - ag->janela_inicio_us;
+    if (decorrido < AGENDADOR_JANELA_OCIOSO_US) {
+        return;
+    }
+    uint64_t ocioso = ag->ocioso_us - ag->janela_ocioso_us;
+    ag->ocioso_permil = (uint16_t)(ocioso * 1000 / decorrido);
+    ag->ocioso_ms = (uint32_t)(ag->ocioso_us / 1000);
+    ag->janela_inicio_us = agora;
+    ag->janela_ocioso_us = ag->ocioso_us;
+}
+
+void agendador_executar(Agendador *ag) {
+    while (true) {
+        if (!agendador_executar_uma(ag)) {
+            // Um alarme que chegue entre a verificação e o __wfe() deixa o evento
+            // armado pelo __sev() e o __wfe() retorna na hora
+            uint64_t antes = time_us_64();
+            __wfe();
+            ag->ocioso_us += time_us_64() - antes;
+        }
+        agendador_contabilizar(ag, time_us_64());
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef AGENDADOR_H
+#define AGENDADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "metricas.h"
+
+// Tarefas registráveis (cada uma ocupa um bit da fila de prontas)
+#define AGENDADOR_MAX_TAREFAS 16
+
+typedef void (*FuncaoTarefa)(void *ctx);
+
+typedef struct Agendador Agendador;
+
+// Tarefa cooperativa: roda até o fim no laço principal, nunca em interrupção
+typedef struct {
+    const char *nome;
+    FuncaoTarefa funcao;
+    void *ctx;
+    uint32_t periodo_us;      // 0 = sob demanda (sinalizada ou disparada uma vez)
+    uint32_t prazo_us;        // prazo relativo à liberação
+    Agendador *dono;
+    uint8_t id;
+    alarm_id_t alarme;
+    uint64_t proxima_us;      // próxima liberação nominal das tarefas periódicas
+    uint64_t liberada_us;     // liberação da ativação pendente
+
+    // Medições
+    uint32_t execucoes;
+    uint32_t overruns;        // terminou depois do prazo
+    uint32_t perdidas;        // liberada de novo antes de executar a ativação anterior
+    uint32_t jitter_ultimo_us; // liberação -> início da execução
+    uint32_t jitter_max_us;
+    uint64_t jitter_soma_us;
+    uint32_t duracao_max_us;
+    Histograma duracao;       // tempo de execução de cada ativação
+} Tarefa;
+
+struct Agendador {
+    alarm_pool_t *pool;         // alarmes disparam no núcleo dono do pool
+    Tarefa tarefas[AGENDADOR_MAX_TAREFAS];
+    uint8_t num_tarefas;
+    volatile uint32_t prontas;  // fila de prontas: bit i = tarefa i liberada
+
+    // Tempo parado em __wfe() (inclui as interrupções atendidas durante a espera)
+    uint64_t ocioso_us;
+    uint64_t janela_inicio_us;
+    uint64_t janela_ocioso_us;
+    volatile uint32_t ocioso_ms;       // total publicado a cada janela, legível de outro núcleo
+    volatile uint16_t ocioso_permil;   // fração ociosa da última janela
+};
+
+// Janela da fração ociosa publicada
+#define AGENDADOR_JANELA_OCIOSO_US 1000000
+
+// pool NULL usa o pool padrão (núcleo 0). Cada núcleo roda o seu agendador, com um
+// pool criado nele mesmo: a fila de prontas só é protegida contra interrupções locais.
+void agendador_init(Agendador *ag, alarm_pool_t *pool);
+
+// Registra uma tarefa e, se periódica, arma o alarme da primeira liberação (daqui a
+// um período). prazo_us = 0 usa o período como prazo. Retorna o id ou -1.
+int agendador_criar(Agendador *ag, const char *nome, FuncaoTarefa funcao, void *ctx,
+                    uint32_t periodo_us, uint32_t prazo_us);
+
+// Libera a tarefa agora; pode ser chamada de interrupção (ex.: botões)
+void agendador_sinalizar(Agendador *ag, int id);
+
+// Libera a tarefa uma única vez daqui a atraso_us, por alarme de hardware
+bool agendador_disparar_em(Agendador *ag, int id, uint32_t atraso_us);
+
+// Muda o período de uma tarefa periódica; a próxima liberação passa a ser daqui a
+// um novo período. Um prazo igual ao período antigo acompanha a mudança.
+void agendador_definir_periodo(Agendador *ag, int id, uint32_t periodo_us);
+
+// Executa a tarefa pronta de prazo mais próximo; false se a fila estiver vazia
+bool agendador_executar_uma(Agendador *ag);
+
+// Laço principal: executa as prontas e dorme em __wfe() quando não há nada a fazer
+void agendador_executar(Agendador *ag);
+
+#endif // AGENDADOR_H
@@ -9,17 +9,45 @@
 #define AHT20_CMD_RESET     0xBA
 #define AHT20_STATUS_BUSY   0x80  // Bit de status ocupado
 #define AHT20_STATUS_CALIBRATED 0x08  // Bit de calibração
+#define AHT20_TIMEOUT_US    10000  // Limite para transações bloqueantes
+#define AHT20_RETRIES       1      // Retentativas da fila por transação
 
-bool aht20_init(i2c_inst_t *i2c) {
-    uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false);
+// CRC-8 do AHT20: polinômio x^8 + x^5 + x^4 + 1 (0x31), valor inicial 0xFF
+static uint8_t aht20_crc8(const uint8_t *data, uint8_t len) {
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static bool aht20_write(AHT20_Dev *dev, const uint8_t *cmd, uint8_t len) {
+    i2c_txn_setup(&dev->txn, dev->addr, cmd, len, NULL, 0);
+    return i2c_queue_transfer(dev->bus, &dev->txn, AHT20_TIMEOUT_US);
+}
+
+static bool aht20_read_status(AHT20_Dev *dev, uint8_t *status) {
+    i2c_txn_setup(&dev->txn, dev->addr, NULL, 0, status, 1);
+    return i2c_queue_transfer(dev->bus, &dev->txn, AHT20_TIMEOUT_US);
+}
+
+static bool aht20_calibrate(AHT20_Dev *dev) {
+    dev->cmd[0] = AHT20_CMD_INIT;
+    dev->cmd[1] = 0x08;
+    dev->cmd[2] = 0x00;
+    if (!aht20_write(dev, dev->cmd, 3)) {
+        return false;
+    }
     sleep_ms(50);  // Aguarda o sensor inicializar
 
     // Verifica status até que o sensor esteja pronto
     uint8_t status;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
+        if (aht20_read_status(dev, &status) &&
+            (status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED) {
             return true;  // Sensor calibrado e pronto
         }
         sleep_ms(10);
@@ -28,52 +56,80 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
-    uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
-
-    // Envia comando de medição
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false);
-    
-    // Aguarda até o sensor estar pronto
-    uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false);
-        if (!(status & AHT20_STATUS_BUSY)) {
-            break;
-        }
-        sleep_ms(10);
+static bool aht20_soft_reset(AHT20_Dev *dev) {
+    dev->cmd[0] = AHT20_CMD_RESET;
+    if (!aht20_write(dev, dev->cmd, 1)) {
+        return false;
     }
-    
-    // Se ainda estiver ocupado, falha na leitura
-    if (status & AHT20_STATUS_BUSY) {
+    sleep_ms(20);
+    return aht20_calibrate(dev);
+}
+
+bool aht20_init(AHT20_Dev *dev, i2c_queue_t *bus) {
+    dev->bus = bus;
+    dev->addr = AHT20_I2C_ADDR;
+    dev->txn.status = I2C_TXN_IDLE;
+    dev->txn.callback = NULL;
+    dev->txn.user = NULL;
+    dev->txn.retries = AHT20_RETRIES;
+    dev->txn.health = (i2c_health_t){0};
+    return aht20_soft_reset(dev);
+}
+
+bool aht20_trigger(AHT20_Dev *dev) {
+    if (i2c_txn_pending(&dev->txn)) {
         return false;
     }
+    dev->cmd[0] = AHT20_CMD_TRIGGER;
+    dev->cmd[1] = 0x33;
+    dev->cmd[2] = 0x00;
+    i2c_txn_setup(&dev->txn, dev->addr, dev->cmd, 3, NULL, 0);
+    return i2c_queue_submit(dev->bus, &dev->txn);
+}
 
-    // Lê os 6 bytes de dados
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) {
+bool aht20_poll(AHT20_Dev *dev) {
+    if (i2c_txn_pending(&dev->txn)) {
         return false;
     }
+    // O primeiro byte lido é o status; se ainda estiver ocupado os demais são descartados.
+    // O sétimo byte é o CRC dos seis anteriores.
+    i2c_txn_setup(&dev->txn, dev->addr, NULL, 0, dev->buf, sizeof(dev->buf));
+    return i2c_queue_submit(dev->bus, &dev->txn);
+}
 
-    // Processa os dados de umidade (20 bits)
+bool aht20_busy(const AHT20_Dev *dev) {
+    return i2c_txn_pending(&dev->txn);
+}
+
+AHT20_Status aht20_result(const AHT20_Dev *dev, AHT20_Data *data) {
+    if (dev->txn.status != I2C_TXN_OK) {
+        return AHT20_ERROR;
+    }
+    const uint8_t *buffer = dev->buf;
+    if (buffer[0] & AHT20_STATUS_BUSY) {
+        return AHT20_BUSY;
+    }
+    if (aht20_crc8(buffer, 6) != buffer[6]) {
+        return AHT20_ERROR;
+    }
+
+    // Processa os dados de umidade (20 bits): RH = raw * 100 / 2^20, em 0.01 %
+    // 10000 / 2^20 = 625 / 2^16, o que mantém o produto dentro de 32 bits
     uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+    data->humidity = (int32_t)((raw_humidity * 625 + 32768) >> 16);
 
-    // Processa os dados de temperatura (20 bits)
+    // Processa os dados de temperatura (20 bits): T = raw * 200 / 2^20 - 50, em 0.01 °C
     uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+    data->temperature = (int32_t)((raw_temp * 1250 + 32768) >> 16) - 5000;
 
-    return true;
+    return AHT20_OK;
 }
 
-void aht20_reset(i2c_inst_t *i2c) {
-    uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false);
-    sleep_ms(20);
-    aht20_init(i2c);
+void aht20_reset(AHT20_Dev *dev) {
+    aht20_soft_reset(dev);
 }
 
-bool aht20_check(i2c_inst_t *i2c) {
+bool aht20_check(AHT20_Dev *dev) {
     uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
+    return aht20_read_status(dev, &status);
 }
@@ -1,6 +1,8 @@
 #ifndef AHT20_H
 #define AHT20_H
 
+#include "hardware/i2c.h"
+#include "i2c_queue.h"
 
 // Endereço I2C do AHT20
 #define AHT20_I2C_ADDR  0x38
@@ -12,19 +14,45 @@
 
 // Estrutura para armazenar os valores de temperatura e umidade
 typedef struct {
-    float temperature;
-    float humidity;
+    int32_t temperature;  // 0.01 °C
+    int32_t humidity;     // 0.01 %RH
 } AHT20_Data;
 
-// Inicializa o sensor AHT20
-bool aht20_init(i2c_inst_t *i2c);
+// Resultado de uma consulta não bloqueante ao AHT20
+typedef enum {
+    AHT20_OK,
+    AHT20_BUSY,
+    AHT20_ERROR
+} AHT20_Status;
 
-// Faz a leitura de temperatura e umidade do AHT20
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data);
+// Contexto do sensor: descritor e buffers da transação em andamento na fila I2C
+typedef struct {
+    i2c_queue_t *bus;
+    uint8_t addr;
+    i2c_txn_t txn;
+    uint8_t cmd[3];
+    uint8_t buf[7];  // status, 5 bytes de dados e CRC
+} AHT20_Dev;
+
+// Reseta e inicializa o sensor AHT20 (bloqueante, usado no boot)
+bool aht20_init(AHT20_Dev *dev, i2c_queue_t *bus);
+
+// Dispara uma medição e retorna imediatamente (conversão leva ~80 ms)
+bool aht20_trigger(AHT20_Dev *dev);
+
+// Enfileira a leitura de status e dados e retorna imediatamente
+bool aht20_poll(AHT20_Dev *dev);
+
+// true enquanto a última transação enfileirada não terminou
+bool aht20_busy(const AHT20_Dev *dev);
+
+// Interpreta a última leitura: AHT20_BUSY enquanto a conversão não terminou,
+// AHT20_ERROR em falha de barramento ou CRC inválido
+AHT20_Status aht20_result(const AHT20_Dev *dev, AHT20_Data *data);
 
 // Reseta o sensor AHT20
-void aht20_reset(i2c_inst_t *i2c);
+void aht20_reset(AHT20_Dev *dev);
 
-bool aht20_check(i2c_inst_t *i2c);
+bool aht20_check(AHT20_Dev *dev);
 
 #endif // AHT20_H
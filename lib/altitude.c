@@ -0,0 +1,68 @@
+#include "altitude.h"
+
+#define ALTITUDE_PASSO_PA 500
+#define ALTITUDE_TABELA_N ((ALTITUDE_PRESSAO_MAX_PA - ALTITUDE_PRESSAO_MIN_PA) / ALTITUDE_PASSO_PA + 1)
+
+// p^0.1903 em Q24 para p = 30000, 30500, ..., 110000 Pa
+static const int32_t tabela_potencia[ALTITUDE_TABELA_N] = {
+    119320776, 119696694, 120067654, 120433801, 120795272, 121152199,
+    121504706, 121852915, 122196941, 122536895, 122872882, 123205005,
+    123533362, 123858047, 124179150, 124496759, 124810957, 125121826,
+    125429442, 125733882, 126035217, 126333517, 126628850, 126921282,
+    127210874, 127497688, 127781783, 128063215, 128342041, 128618312,
+    128892082, 129163399, 129432313, 129698870, 129963117, 130225097,
+    130484854, 130742429, 130997863, 131251195, 131502463, 131751705,
+    131998957, 132244254, 132487630, 132729119, 132968752, 133206562,
+    133442579, 133676834, 133909354, 134140169, 134369307, 134596794,
+    134822657, 135046921, 135269612, 135490753, 135710370, 135928484,
+    136145120, 136360299, 136574042, 136786372, 136997308, 137206872,
+    137415082, 137621959, 137827521, 138031787, 138234774, 138436501,
+    138636986, 138836244, 139034292, 139231148, 139426826, 139621343,
+    139814714, 140006953, 140198076, 140388096, 140577029, 140764887,
+    140951684, 141137434, 141322150, 141505844, 141688529, 141870218,
+    142050921, 142230652, 142409422, 142587241, 142764123, 142940076,
+    143115113, 143289244, 143462479, 143634829, 143806303, 143976911,
+    144146664, 144315570, 144483639, 144650881, 144817304, 144982917,
+    145147729, 145311748, 145474984, 145637444, 145799136, 145960069,
+    146120251, 146279689, 146438391, 146596365, 146753617, 146910156,
+    147065988, 147221121, 147375562, 147529316, 147682393, 147834796,
+    147986535, 148137614, 148288041, 148437821, 148586960, 148735466,
+    148883343, 149030598, 149177236, 149323264, 149468687, 149613510,
+    149757739, 149901379, 150044436, 150186915, 150328822, 150470160,
+    150610936, 150751155, 150890820, 151029938, 151168513, 151306549,
+    151444051, 151581025, 151717474, 151853402, 151988815, 152123716,
+    152258111, 152392002, 152525395, 152658293, 152790701
+};
+
+// Valores derivados da referência: f(p0) e 443300 / f(p0) em Q32
+static int32_t f_referencia;
+static int64_t escala_referencia;
+
+static int32_t potencia_interpolada(uint32_t p) {
+    if (p <= ALTITUDE_PRESSAO_MIN_PA) {
+        return tabela_potencia[0];
+    }
+    if (p >= ALTITUDE_PRESSAO_MAX_PA) {
+        return tabela_potencia[ALTITUDE_TABELA_N - 1];
+    }
+    uint32_t deslocamento = p - ALTITUDE_PRESSAO_MIN_PA;
+    uint32_t i = deslocamento / ALTITUDE_PASSO_PA;
+    int32_t frac = deslocamento % ALTITUDE_PASSO_PA;
+    int32_t delta = tabela_potencia[i + 1] - tabela_potencia[i];  // < 2^20, não estoura com frac < 500
+    return tabela_potencia[i] + (delta * frac) / ALTITUDE_PASSO_PA;
+}
+
+void altitude_definir_referencia(uint32_t p0_pa) {
+    // A divisão de 64 bits acontece só aqui; cada amostra custa uma multiplicação e um shift
+    f_referencia = potencia_interpolada(p0_pa);
+    escala_referencia = ((int64_t)443300 << 32) / f_referencia;
+}
+
+int32_t altitude_calcular_dm(uint32_t pressao_pa) {
+    if (f_referencia == 0) {
+        altitude_definir_referencia(ALTITUDE_REFERENCIA_PADRAO_PA);
+    }
+    // h = 443300 dm * (f(p0) - f(p)) / f(p0)
+    int64_t diferenca = f_referencia - potencia_interpolada(pressao_pa);
+    return (int32_t)((diferenca * escala_referencia) >> 32);
+}
@@ -0,0 +1,22 @@
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+
+#include <stdint.h>
+
+// Faixa coberta pela tabela; pressões fora dela são saturadas nas bordas
+#define ALTITUDE_PRESSAO_MIN_PA 30000
+#define ALTITUDE_PRESSAO_MAX_PA 110000
+
+// Pressão de referência ao nível do mar padrão
+#define ALTITUDE_REFERENCIA_PADRAO_PA 101325
+
+// Define a pressão ao nível do mar usada como referência (Pa)
+void altitude_definir_referencia(uint32_t p0_pa);
+
+// Altitude barométrica em decímetros, equivalente a 44330 * (1 - (p/p0)^0.1903),
+// calculada só com inteiros: tabela de p^0.1903 a cada 500 Pa com interpolação linear.
+// Erro máximo frente à fórmula em ponto flutuante: 0,19 m entre 30 e 110 kPa
+// (0,13 m entre 60 e 110 kPa), para referências de 95 a 105 kPa.
+int32_t altitude_calcular_dm(uint32_t pressao_pa);
+
+#endif // ALTITUDE_H
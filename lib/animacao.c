@@ -0,0 +1,164 @@
+#include "animacao.h"
+#include "hardware/sync.h"
+
+// mistura[k][v] = v * k / (ANIM_PASSOS - 1): a mistura de dois valores é a soma de duas
+// consultas, que nunca passa de 255
+static uint8_t mistura[ANIM_PASSOS][256];
+
+static int64_t animacao_alarme(alarm_id_t id, void *user);
+
+void animacao_brilho(Animacao *a, uint8_t brilho) {
+    a->brilho = brilho;
+    for (uint32_t v = 0; v < 256; v++) {
+        uint32_t gama = (v * v + 127) / 255;
+        a->lut[v] = (uint8_t)((gama * brilho + 127) / 255);
+    }
+}
+
+void animacao_init(Animacao *a, MatrizLeds *m, alarm_pool_t *pool) {
+    for (uint32_t k = 0; k < ANIM_PASSOS; k++) {
+        for (uint32_t v = 0; v < 256; v++) {
+            mistura[k][v] = (uint8_t)(v * k / (ANIM_PASSOS - 1));
+        }
+    }
+    a->matriz = m;
+    a->pool = pool ? pool : alarm_pool_get_default();
+    animacao_brilho(a, ANIM_BRILHO_PADRAO);
+    a->seq = NULL;
+    a->chave = 0;
+    a->chave_ms = 0;
+    a->transicao_ms = ANIM_TRANSICAO_MS;
+    a->barra_restante_ms = 0;
+    a->barra_alvo = 0;
+    a->barra_atual = 0;
+    a->quadros = 0;
+    for (uint8_t i = 0; i < MATRIZ_PIXELS; i++) {
+        a->saida.px[i] = (CorLed){0, 0, 0};
+    }
+    // Retorno negativo no alarme reagenda a partir do horário previsto: taxa fixa
+    alarm_pool_add_alarm_in_ms(a->pool, ANIM_PERIODO_MS, animacao_alarme, a, true);
+}
+
+// Passo de mistura do tempo decorrido num intervalo (um divisor por quadro, não por pixel)
+static inline uint8_t animacao_passo(uint32_t decorrido_ms, uint32_t total_ms) {
+    if (total_ms == 0 || decorrido_ms >= total_ms) {
+        return ANIM_PASSOS - 1;
+    }
+    return (uint8_t)(decorrido_ms * (ANIM_PASSOS - 1) / total_ms);
+}
+
+static inline CorLed animacao_misturar(CorLed de, CorLed para, uint8_t passo) {
+    const uint8_t *m0 = mistura[ANIM_PASSOS - 1 - passo], *m1 = mistura[passo];
+    return (CorLed){m0[de.r] + m1[para.r], m0[de.g] + m1[para.g], m0[de.b] + m1[para.b]};
+}
+
+// Fonte do quadro sem a transição: barra, se ativa, ou a sequência
+static void animacao_fonte(Animacao *a, QuadroLed *q) {
+    if (a->barra_restante_ms) {
+        for (uint8_t i = 0; i < MATRIZ_PIXELS; i++) {
+            q->px[i] = i < a->barra_atual ? a->barra_cor : (CorLed){0, 0, 0};
+        }
+        return;
+    }
+    if (!a->seq) {
+        for (uint8_t i = 0; i < MATRIZ_PIXELS; i++) {
+            q->px[i] = (CorLed){0, 0, 0};
+        }
+        return;
+    }
+
+    const Sequencia *s = a->seq;
+    const QuadroChave *k = &s->chaves[a->chave];
+    uint8_t prox = a->chave + 1 < s->num_chaves ? a->chave + 1 : (s->repetir ? 0 : a->chave);
+    const QuadroLed *de = k->quadro, *para = s->chaves[prox].quadro;
+    uint8_t passo = animacao_passo(a->chave_ms, k->duracao_ms);
+    for (uint8_t i = 0; i < MATRIZ_PIXELS; i++) {
+        q->px[i] = animacao_misturar(de->px[i], para->px[i], passo);
+    }
+}
+
+// Avança os relógios de um quadro; chamada no alarme
+static void animacao_avancar(Animacao *a) {
+    if (a->transicao_ms < ANIM_TRANSICAO_MS) {
+        a->transicao_ms += ANIM_PERIODO_MS;
+    }
+    if (a->barra_restante_ms) {
+        if (a->barra_atual < a->barra_alvo) a->barra_atual++;
+        else if (a->barra_atual > a->barra_alvo) a->barra_atual--;
+        if (a->barra_restante_ms > ANIM_PERIODO_MS) {
+            a->barra_restante_ms -= ANIM_PERIODO_MS;
+        } else {
+            // Fim da barra: a sequência volta com transição
+            a->barra_restante_ms = 0;
+            a->origem = a->saida;
+            a->transicao_ms = 0;
+        }
+        return;  // a sequência fica parada enquanto a barra aparece
+    }
+    if (!a->seq) {
+        return;
+    }
+    const Sequencia *s = a->seq;
+    a->chave_ms += ANIM_PERIODO_MS;
+    if (a->chave_ms >= s->chaves[a->chave].duracao_ms) {
+        if (a->chave + 1 < s->num_chaves) {
+            a->chave++;
+            a->chave_ms = 0;
+        } else if (s->repetir) {
+            a->chave = 0;
+            a->chave_ms = 0;
+        } else {
+            a->chave_ms = s->chaves[a->chave].duracao_ms;  // parado no último
+        }
+    }
+}
+
+static int64_t animacao_alarme(alarm_id_t id, void *user) {
+    Animacao *a = (Animacao *)user;
+
+    QuadroLed fonte;
+    animacao_fonte(a, &fonte);
+    uint8_t passo = animacao_passo(a->transicao_ms, ANIM_TRANSICAO_MS);
+
+    uint32_t palavras[MATRIZ_PIXELS];
+    for (uint8_t i = 0; i < MATRIZ_PIXELS; i++) {
+        CorLed c = passo < ANIM_PASSOS - 1 ? animacao_misturar(a->origem.px[i], fonte.px[i], passo) : fonte.px[i];
+        a->saida.px[i] = c;
+        palavras[i] = MATRIZ_GRB(a->lut[c.r], a->lut[c.g], a->lut[c.b]);
+    }
+    // Sem bloquear: quadro igual é suprimido, matriz ocupada adia para o próximo
+    matriz_enviar(a->matriz, palavras);
+    a->quadros++;
+
+    animacao_avancar(a);
+    return -(int64_t)ANIM_PERIODO_MS * 1000;
+}
+
+void animacao_tocar(Animacao *a, const Sequencia *seq) {
+    uint32_t irq = save_and_disable_interrupts();
+    if (seq != a->seq) {
+        a->origem = a->saida;
+        a->transicao_ms = 0;
+        a->seq = seq;
+        a->chave = 0;
+        a->chave_ms = 0;
+    }
+    restore_interrupts(irq);
+}
+
+void animacao_barra(Animacao *a, uint8_t pixels, CorLed cor, uint16_t duracao_ms) {
+    if (pixels > MATRIZ_PIXELS) {
+        pixels = MATRIZ_PIXELS;
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    if (!a->barra_restante_ms) {
+        // Entrada da barra: transição a partir do que está aceso, barra crescendo do zero
+        a->origem = a->saida;
+        a->transicao_ms = 0;
+        a->barra_atual = 0;
+    }
+    a->barra_alvo = pixels;
+    a->barra_cor = cor;
+    a->barra_restante_ms = duracao_ms ? duracao_ms : 1;
+    restore_interrupts(irq);
+}
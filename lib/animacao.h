@@ -0,0 +1,94 @@
+#ifndef ANIMACAO_H
+#define ANIMACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "matriz.h"
+
+// Animações da matriz de LEDs a taxa fixa, num alarme: sequências de quadros-chave com
+// mistura entre eles, transições suaves ao trocar de sequência e uma barra de valor
+// sobreposta. Os quadros são descritos em cor linear (0..255) e passam por uma tabela
+// de gama e brilho na saída; misturas usam tabelas pré-calculadas, sem multiplicar
+// por pixel.
+
+#define ANIM_PERIODO_MS 33          // ~30 quadros/s
+#define ANIM_PASSOS 16              // níveis de mistura entre dois quadros
+#define ANIM_TRANSICAO_MS 400       // troca de sequência e entrada/saída da barra
+#define ANIM_BRILHO_PADRAO 24       // saída do branco pleno depois da gama
+
+typedef struct {
+    uint8_t r, g, b;
+} CorLed;
+
+// Quadro em cor linear, na ordem dos LEDs
+typedef struct {
+    CorLed px[MATRIZ_PIXELS];
+} QuadroLed;
+
+// A sequência vai de cada quadro ao seguinte em 'duracao_ms', misturando os dois
+typedef struct {
+    const QuadroLed *quadro;
+    uint16_t duracao_ms;
+} QuadroChave;
+
+typedef struct {
+    const QuadroChave *chaves;
+    uint8_t num_chaves;
+    bool repetir;          // sem repetição o último quadro fica parado
+} Sequencia;
+
+// Máscara de 25 bits a partir das linhas (5 bits cada, o bit 4 é a primeira coluna)
+#define ANIM_MASCARA(l0, l1, l2, l3, l4) \
+    (((uint32_t)(l0) << 20) | ((uint32_t)(l1) << 15) | ((uint32_t)(l2) << 10) | ((uint32_t)(l3) << 5) | (uint32_t)(l4))
+#define ANIM_PX(m, i, r, g, b) \
+    {(((m) >> (24 - (i))) & 1) * (r), (((m) >> (24 - (i))) & 1) * (g), (((m) >> (24 - (i))) & 1) * (b)}
+// Quadro constante de uma cor só, aceso onde a máscara tem 1 (resolvido em compilação)
+#define ANIM_QUADRO(m, r, g, b) {{ \
+    ANIM_PX(m, 0, r, g, b),  ANIM_PX(m, 1, r, g, b),  ANIM_PX(m, 2, r, g, b),  ANIM_PX(m, 3, r, g, b),  \
+    ANIM_PX(m, 4, r, g, b),  ANIM_PX(m, 5, r, g, b),  ANIM_PX(m, 6, r, g, b),  ANIM_PX(m, 7, r, g, b),  \
+    ANIM_PX(m, 8, r, g, b),  ANIM_PX(m, 9, r, g, b),  ANIM_PX(m, 10, r, g, b), ANIM_PX(m, 11, r, g, b), \
+    ANIM_PX(m, 12, r, g, b), ANIM_PX(m, 13, r, g, b), ANIM_PX(m, 14, r, g, b), ANIM_PX(m, 15, r, g, b), \
+    ANIM_PX(m, 16, r, g, b), ANIM_PX(m, 17, r, g, b), ANIM_PX(m, 18, r, g, b), ANIM_PX(m, 19, r, g, b), \
+    ANIM_PX(m, 20, r, g, b), ANIM_PX(m, 21, r, g, b), ANIM_PX(m, 22, r, g, b), ANIM_PX(m, 23, r, g, b), \
+    ANIM_PX(m, 24, r, g, b) }}
+
+typedef struct {
+    MatrizLeds *matriz;
+    alarm_pool_t *pool;
+    uint8_t lut[256];          // gama 2 e brilho global
+    uint8_t brilho;
+
+    // Sequência em execução
+    const Sequencia *seq;
+    uint8_t chave;
+    uint16_t chave_ms;         // tempo decorrido na chave atual
+
+    // Transição do último quadro mostrado para a fonte atual
+    QuadroLed origem;
+    uint16_t transicao_ms;     // >= ANIM_TRANSICAO_MS: sem transição
+
+    // Barra de valor: acende os 'barra_alvo' primeiros LEDs, um por quadro até lá
+    uint16_t barra_restante_ms;
+    uint8_t barra_alvo;
+    uint8_t barra_atual;
+    CorLed barra_cor;
+
+    QuadroLed saida;           // último quadro composto, em cor linear
+    uint32_t quadros;
+} Animacao;
+
+// Começa a rodar no pool dado (NULL = padrão), com a matriz apagada
+void animacao_init(Animacao *a, MatrizLeds *m, alarm_pool_t *pool);
+
+// Recalcula a tabela de saída; 'brilho' é o valor do branco pleno
+void animacao_brilho(Animacao *a, uint8_t brilho);
+
+// Troca para a sequência, com transição a partir do que está aceso.
+// A mesma sequência em execução não reinicia.
+void animacao_tocar(Animacao *a, const Sequencia *seq);
+
+// Mostra uma barra de 'pixels' (0..MATRIZ_PIXELS) LEDs por 'duracao_ms' e volta à sequência
+void animacao_barra(Animacao *a, uint8_t pixels, CorLed cor, uint16_t duracao_ms);
+
+#endif // ANIMACAO_H
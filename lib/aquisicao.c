@@ -0,0 +1,81 @@
+#include "aquisicao.h"
+#include "pico/stdlib.h"
+
+void aquisicao_init(Aquisicao *aq, AHT20_Dev *aht) {
+    aq->aht = aht;
+    aq->estado = AQUISICAO_OCIOSA;
+    aq->etapa_aht = ETAPA_CONCLUIDA;
+    aq->proximo_poll_us = 0;
+}
+
+bool aquisicao_iniciar(Aquisicao *aq) {
+    if (aq->estado != AQUISICAO_OCIOSA) {
+        return false;
+    }
+
+    AmostraSensores *a = &aq->amostra;
+    a->aht_ok = false;
+    a->duracao_aht_us = 0;
+    a->inicio_us = time_us_64();
+
+    aq->etapa_aht = aht20_trigger(aq->aht) ? ETAPA_CONVERTENDO : ETAPA_CONCLUIDA;
+    aq->proximo_poll_us = a->inicio_us + AQUISICAO_POLL_US;
+    aq->estado = AQUISICAO_CONVERTENDO;
+    return true;
+}
+
+static void aquisicao_avancar_aht(Aquisicao *aq, uint32_t decorrido) {
+    AmostraSensores *a = &aq->amostra;
+    if (aht20_busy(aq->aht)) {
+        return;
+    }
+
+    if (aq->etapa_aht == ETAPA_CONVERTENDO) {
+        if (aq->aht->txn.status != I2C_TXN_OK) {
+            aq->etapa_aht = ETAPA_CONCLUIDA;  // disparo não foi aceito
+        } else if (decorrido >= AQUISICAO_AHT20_MIN_US && aht20_poll(aq->aht)) {
+            aq->etapa_aht = ETAPA_LENDO;
+        }
+        return;
+    }
+
+    AHT20_Status st = aht20_result(aq->aht, &a->aht);
+    if (st == AHT20_BUSY) {
+        aq->etapa_aht = ETAPA_CONVERTENDO;
+        return;
+    }
+    a->aht_ok = (st == AHT20_OK);
+    a->duracao_aht_us = decorrido;
+    aq->etapa_aht = ETAPA_CONCLUIDA;
+}
+
+bool aquisicao_processar(Aquisicao *aq) {
+    if (aq->estado != AQUISICAO_CONVERTENDO) {
+        return false;
+    }
+
+    uint64_t agora = time_us_64();
+    if (agora < aq->proximo_poll_us) {
+        return false;
+    }
+
+    uint32_t decorrido = (uint32_t)(agora - aq->amostra.inicio_us);
+
+    if (aq->etapa_aht != ETAPA_CONCLUIDA) {
+        aquisicao_avancar_aht(aq, decorrido);
+    }
+
+    // Sensor que não respondeu a tempo fica marcado como falho nesta amostra.
+    // Uma transação ainda na fila termina sozinha; o próximo disparo só é aceito depois.
+    if (decorrido >= AQUISICAO_TIMEOUT_US) {
+        aq->etapa_aht = ETAPA_CONCLUIDA;
+    }
+
+    if (aq->etapa_aht != ETAPA_CONCLUIDA) {
+        aq->proximo_poll_us = agora + AQUISICAO_POLL_US;
+        return false;
+    }
+
+    aq->estado = AQUISICAO_OCIOSA;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef AQUISICAO_H
+#define AQUISICAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "aht20.h"
+
+// Tempo máximo de espera por uma conversão antes de descartar a amostra
+#define AQUISICAO_TIMEOUT_US 150000
+// Intervalo mínimo entre consultas de status no barramento
+#define AQUISICAO_POLL_US 10000
+// O AHT20 não termina antes de ~75 ms; não adianta consultá-lo antes disso
+#define AQUISICAO_AHT20_MIN_US 75000
+
+typedef enum {
+    AQUISICAO_OCIOSA,
+    AQUISICAO_CONVERTENDO
+} EstadoAquisicao;
+
+// Etapa de cada sensor dentro de um ciclo
+typedef enum {
+    ETAPA_CONCLUIDA,
+    ETAPA_CONVERTENDO,  // disparo enfileirado, aguardando o tempo de conversão
+    ETAPA_LENDO         // leitura de status/dados enfileirada na fila I2C
+} EtapaSensor;
+
+// Resultado de um ciclo de aquisição
+typedef struct {
+    bool aht_ok;
+    AHT20_Data aht;
+    uint64_t inicio_us;     // instante do disparo
+    uint32_t duracao_aht_us; // disparo -> AHT20 pronto
+} AmostraSensores;
+
+// Ciclo de disparo e leitura de um AHT20. O BMP280 roda em modo normal e é lido pelo
+// barômetro (ver barometro.h), fora deste ciclo.
+typedef struct {
+    AHT20_Dev *aht;
+    EstadoAquisicao estado;
+    EtapaSensor etapa_aht;
+    uint64_t proximo_poll_us;
+    AmostraSensores amostra;
+} Aquisicao;
+
+void aquisicao_init(Aquisicao *aq, AHT20_Dev *aht);
+
+// Dispara a conversão do AHT20 e retorna imediatamente.
+// Retorna false se um ciclo anterior ainda estiver em andamento.
+bool aquisicao_iniciar(Aquisicao *aq);
+
+// Avança a máquina de estados sem bloquear: as transferências I2C correm na fila
+// em segundo plano. Retorna true uma única vez por ciclo, quando o sensor terminou
+// (ou expirou); a amostra fica em aq->amostra.
+bool aquisicao_processar(Aquisicao *aq);
+
+#endif // AQUISICAO_H
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include "arranjo.h"
+#include "pico/stdlib.h"
+
+// Tolerâncias padrão do modo voto: acima disso o sensor é considerado discordante
+#define TOLERANCIA_TEMP_PADRAO 100      // 1 °C
+#define TOLERANCIA_UMID_PADRAO 300      // 3 %
+#define TOLERANCIA_PRESSAO_PADRAO 100   // 100 Pa
+
+static int32_t media_arredondada(int64_t soma, uint8_t n) {
+    return (int32_t)(soma >= 0 ? (soma + n / 2) / n : (soma - n / 2) / n);
+}
+
+uint8_t arranjo_agregar(const int32_t *valores, uint8_t n, ModoAgregacao modo, int32_t tolerancia, int32_t *out) {
+    if (n == 0) {
+        return 0;
+    }
+
+    // Poucos sensores: inserção direta em cópia local
+    int32_t v[ARRANJO_MAX_SENSORES];
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t x = valores[i];
+        uint8_t j = i;
+        while (j > 0 && v[j - 1] > x) {
+            v[j] = v[j - 1];
+            j--;
+        }
+        v[j] = x;
+    }
+
+    int64_t soma = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        soma += v[i];
+    }
+    int32_t mediana = (n & 1) ? v[n / 2] : media_arredondada((int64_t)v[n / 2 - 1] + v[n / 2], 2);
+
+    switch (modo) {
+        case AGREGACAO_MEDIA:
+            *out = media_arredondada(soma, n);
+            return n;
+        case AGREGACAO_MEDIANA:
+            *out = mediana;
+            return n;
+        case AGREGACAO_VOTO:
+        default: {
+            int64_t soma_votos = 0;
+            uint8_t votos = 0;
+            for (uint8_t i = 0; i < n; i++) {
+                int32_t d = v[i] - mediana;
+                if (d >= -tolerancia && d <= tolerancia) {
+                    soma_votos += v[i];
+                    votos++;
+                }
+            }
+            // Sem maioria (dois sensores discordantes): fica com a mediana
+            *out = votos ? media_arredondada(soma_votos, votos) : mediana;
+            return votos ? votos : n;
+        }
+    }
+}
+
+static uint8_t arranjo_registrar(ArranjoSensores *arr, TipoSensor tipo, uint8_t barramento, uint8_t endereco) {
+    SensorArranjo *s = &arr->sensores[arr->num_sensores];
+    s->tipo = tipo;
+    s->barramento = barramento;
+    s->endereco = endereco;
+    s->valido = false;
+    s->temperatura = 0;
+    s->valor = 0;
+    s->leituras = 0;
+    s->falhas = 0;
+    s->i2c_ok = 0;
+    s->nacks = 0;
+    s->timeouts = 0;
+    s->erros = 0;
+    s->ultimo_ok_ms = 0;
+    s->idade_ms = 0;
+    s->obsoleto = true;  // até a primeira leitura boa
+    return arr->num_sensores++;
+}
+
+static void arranjo_atualizar_sensor(SensorArranjo *s, bool ok, int32_t temperatura, int32_t valor) {
+    s->valido = ok;
+    if (ok) {
+        s->temperatura = temperatura;
+        s->valor = valor;
+        s->leituras++;
+        s->ultimo_ok_ms = to_ms_since_boot(get_absolute_time());
+        s->obsoleto = false;
+    } else {
+        s->falhas++;
+    }
+}
+
+uint8_t arranjo_iniciar(ArranjoSensores *arr, i2c_queue_t *const barramentos[], uint8_t num_barramentos,
+                        bmp280_profile_t perfil, ModoAgregacao modo, alarm_pool_t *pool) {
+    static const uint8_t enderecos_bmp[] = {BMP280_I2C_ADDR_PRIM, BMP280_I2C_ADDR_SEC};
+    uint8_t barramento_bmp[ARRANJO_MAX_BMP280];
+
+    arr->num_barramentos = 0;
+    arr->num_aht = 0;
+    arr->num_bmp = 0;
+    arr->num_sensores = 0;
+    arr->rodada_aht = false;
+    arr->rodada_bmp = 0;
+    arr->inicio_rodada_bmp_ms = 0;
+    arr->modo = modo;
+    arr->tolerancia_temp = TOLERANCIA_TEMP_PADRAO;
+    arr->tolerancia_umid = TOLERANCIA_UMID_PADRAO;
+    arr->tolerancia_pressao = TOLERANCIA_PRESSAO_PADRAO;
+
+    for (uint8_t b = 0; b < num_barramentos && b < ARRANJO_MAX_BARRAMENTOS; b++) {
+        arr->barramentos[arr->num_barramentos++] = barramentos[b];
+        uint8_t mapa[16];
+        uint8_t encontrados = i2c_queue_scan(barramentos[b], mapa);
+        printf("i2c%u: %u dispositivo(s)\n", b, encontrados);
+
+        if (i2c_queue_scan_found(mapa, AHT20_I2C_ADDR) && arr->num_aht < ARRANJO_MAX_AHT20) {
+            AHT20_Dev *aht = &arr->aht[arr->num_aht];
+            if (aht20_init(aht, barramentos[b])) {
+                aquisicao_init(&arr->aquisicao[arr->num_aht], aht);
+                arranjo_registrar(arr, SENSOR_AHT20, b, AHT20_I2C_ADDR);
+                arr->num_aht++;
+            } else {
+                printf("AHT20 em i2c%u nao respondeu\n", b);
+            }
+        }
+
+        for (uint8_t i = 0; i < count_of(enderecos_bmp); i++) {
+            if (!i2c_queue_scan_found(mapa, enderecos_bmp[i]) || arr->num_bmp >= ARRANJO_MAX_BMP280) {
+                continue;
+            }
+            // Outro dispositivo pode ocupar o endereço: o chip ID confirma o BMP280
+            if (bmp280_init(&arr->bmp[arr->num_bmp], barramentos[b], enderecos_bmp[i])) {
+                barramento_bmp[arr->num_bmp++] = b;
+            }
+        }
+    }
+
+    // Todos os BMP280 no mesmo timer; o barômetro pode recusar um sensor que não aceitou o perfil
+    bmp280_dev_t *devs[ARRANJO_MAX_BMP280];
+    for (uint8_t i = 0; i < arr->num_bmp; i++) {
+        devs[i] = &arr->bmp[i];
+    }
+    arr->barometro.num_sensores = 0;
+    if (arr->num_bmp && !barometro_iniciar(&arr->barometro, devs, arr->num_bmp, perfil, pool)) {
+        printf("Falha ao configurar amostragem do BMP280\n");
+    }
+
+    arr->primeiro_bmp = arr->num_sensores;
+    for (uint8_t i = 0; i < arr->barometro.num_sensores; i++) {
+        const bmp280_dev_t *dev = arr->barometro.sensores[i].dev;
+        arranjo_registrar(arr, SENSOR_BMP280, barramento_bmp[dev - arr->bmp], dev->addr);
+    }
+
+    return arr->num_sensores;
+}
+
+bool arranjo_disparar(ArranjoSensores *arr) {
+    if (arr->rodada_aht) {
+        return false;
+    }
+    // Todos os disparos entram nas filas no mesmo tick e os sensores convertem em paralelo
+    for (uint8_t i = 0; i < arr->num_aht; i++) {
+        aquisicao_iniciar(&arr->aquisicao[i]);
+    }
+    arr->rodada_aht = true;
+    return true;
+}
+
+bool arranjo_coletar(ArranjoSensores *arr, AmostraSensores *out) {
+    if (!arr->rodada_aht) {
+        return false;
+    }
+
+    bool pendente = false;
+    for (uint8_t i = 0; i < arr->num_aht; i++) {
+        Aquisicao *aq = &arr->aquisicao[i];
+        if (aq->estado == AQUISICAO_OCIOSA) {
+            continue;
+        }
+        if (aquisicao_processar(aq)) {
+            arranjo_atualizar_sensor(&arr->sensores[i], aq->amostra.aht_ok,
+                                     aq->amostra.aht.temperature, aq->amostra.aht.humidity);
+        } else {
+            pendente = true;
+        }
+    }
+    if (pendente) {
+        return false;
+    }
+    arr->rodada_aht = false;
+
+    int32_t temps[ARRANJO_MAX_AHT20], umids[ARRANJO_MAX_AHT20];
+    uint8_t n = 0;
+    *out = (AmostraSensores){0};
+    for (uint8_t i = 0; i < arr->num_aht; i++) {
+        const AmostraSensores *a = &arr->aquisicao[i].amostra;
+        if (i == 0) {
+            out->inicio_us = a->inicio_us;
+        }
+        if (a->duracao_aht_us > out->duracao_aht_us) {
+            out->duracao_aht_us = a->duracao_aht_us;
+        }
+        if (arr->sensores[i].valido) {
+            temps[n] = arr->sensores[i].temperatura;
+            umids[n] = arr->sensores[i].valor;
+            n++;
+        }
+    }
+
+    out->aht_ok = n > 0;
+    arranjo_agregar(temps, n, arr->modo, arr->tolerancia_temp, &out->aht.temperature);
+    arranjo_agregar(umids, n, arr->modo, arr->tolerancia_umid, &out->aht.humidity);
+    return true;
+}
+
+// Descritor de transação de cada sensor, onde a fila acumula os contadores de saúde
+static const i2c_txn_t *arranjo_txn(const ArranjoSensores *arr, uint8_t i) {
+    if (arr->sensores[i].tipo == SENSOR_AHT20) {
+        return &arr->aht[i].txn;
+    }
+    return &arr->barometro.sensores[i - arr->primeiro_bmp].dev->txn;
+}
+
+void arranjo_supervisionar(ArranjoSensores *arr, uint32_t agora_ms) {
+    for (uint8_t b = 0; b < arr->num_barramentos; b++) {
+        if (i2c_queue_watchdog(arr->barramentos[b])) {
+            printf("i2c%u: barramento recuperado\n", b);
+        }
+    }
+
+    for (uint8_t i = 0; i < arr->num_sensores; i++) {
+        SensorArranjo *s = &arr->sensores[i];
+        const i2c_health_t *h = &arranjo_txn(arr, i)->health;
+        s->i2c_ok = h->ok;
+        s->nacks = h->nacks;
+        s->timeouts = h->timeouts;
+        s->erros = h->errors;
+        s->idade_ms = s->leituras ? agora_ms - s->ultimo_ok_ms : 0;
+        s->obsoleto = !s->leituras || s->idade_ms > ARRANJO_VALIDADE_MS;
+        if (s->obsoleto) {
+            s->valido = false;
+        }
+    }
+}
+
+bool arranjo_coletar_barometro(ArranjoSensores *arr, LeituraBarometro *out) {
+    uint8_t num = arr->barometro.num_sensores;
+    uint8_t todos = (uint8_t)((1u << num) - 1);
+    uint32_t agora = to_ms_since_boot(get_absolute_time());
+
+    for (uint8_t i = 0; i < num; i++) {
+        // Quem já entregou espera a próxima rodada com as amostras no buffer circular
+        if (arr->rodada_bmp & (1u << i)) {
+            continue;
+        }
+        LeituraBarometro leitura;
+        if (barometro_decimar(&arr->barometro, i, &leitura)) {
+            if (arr->rodada_bmp == 0) {
+                arr->inicio_rodada_bmp_ms = agora;
+            }
+            arr->leitura_bmp[i] = leitura;
+            arr->rodada_bmp |= 1u << i;
+        }
+    }
+    if (num == 0 || arr->rodada_bmp == 0) {
+        return false;
+    }
+    // Os sensores dividem o timer e entregam no mesmo tick: meio período de saída sem
+    // a entrega de um deles é atraso ou falha
+    const Barometro *b = &arr->barometro;
+    uint32_t prazo_ms = (uint32_t)b->fator * 1000 / b->taxa_hz / 2;
+    if (arr->rodada_bmp != todos && agora - arr->inicio_rodada_bmp_ms < prazo_ms) {
+        return false;
+    }
+
+    int32_t temps[BAROMETRO_MAX_SENSORES], pressoes[BAROMETRO_MAX_SENSORES];
+    int32_t mins[BAROMETRO_MAX_SENSORES], maxs[BAROMETRO_MAX_SENSORES];
+    uint8_t n = 0;
+    uint16_t amostras = 0;
+    for (uint8_t i = 0; i < num; i++) {
+        bool ok = arr->rodada_bmp & (1u << i);
+        const LeituraBarometro *l = &arr->leitura_bmp[i];
+        arranjo_atualizar_sensor(&arr->sensores[arr->primeiro_bmp + i], ok, l->temperatura, (int32_t)l->pressao);
+        if (ok) {
+            temps[n] = l->temperatura;
+            pressoes[n] = (int32_t)l->pressao;
+            mins[n] = (int32_t)l->pressao_min;
+            maxs[n] = (int32_t)l->pressao_max;
+            amostras += l->amostras;
+            n++;
+        }
+    }
+    arr->rodada_bmp = 0;
+    if (n == 0) {
+        return false;  // rodada sem nenhum sensor válido: nada a agregar
+    }
+
+    int32_t v;
+    arranjo_agregar(temps, n, arr->modo, arr->tolerancia_temp, &out->temperatura);
+    arranjo_agregar(pressoes, n, arr->modo, arr->tolerancia_pressao, &v);
+    out->pressao = (uint32_t)v;
+    arranjo_agregar(mins, n, arr->modo, arr->tolerancia_pressao, &v);
+    out->pressao_min = (uint32_t)v;
+    arranjo_agregar(maxs, n, arr->modo, arr->tolerancia_pressao, &v);
+    out->pressao_max = (uint32_t)v;
+    out->amostras = amostras;
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef ARRANJO_H
+#define ARRANJO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_queue.h"
+#include "aht20.h"
+#include "bmp280.h"
+#include "aquisicao.h"
+#include "barometro.h"
+
+// Barramentos varridos (i2c0 e i2c1) e sensores suportados por barramento:
+// o AHT20 tem endereço fixo, o BMP280 aceita 0x76 e 0x77
+#define ARRANJO_MAX_BARRAMENTOS 2
+#define ARRANJO_MAX_AHT20 ARRANJO_MAX_BARRAMENTOS
+#define ARRANJO_MAX_BMP280 (2 * ARRANJO_MAX_BARRAMENTOS)
+#define ARRANJO_MAX_SENSORES (ARRANJO_MAX_AHT20 + ARRANJO_MAX_BMP280)
+// Sem leitura boa há mais que isso, o sensor é marcado como obsoleto (3x o nível
+// mais lento da amostragem adaptativa)
+#define ARRANJO_VALIDADE_MS 15000
+
+typedef enum {
+    SENSOR_AHT20,
+    SENSOR_BMP280
+} TipoSensor;
+
+// Como as leituras dos vários sensores viram um valor só
+typedef enum {
+    AGREGACAO_MEDIA,    // média de todos os sensores válidos
+    AGREGACAO_MEDIANA,  // valor central (média dos dois centrais quando par)
+    AGREGACAO_VOTO      // média dos sensores que concordam com a mediana dentro da tolerância
+} ModoAgregacao;
+
+// Última leitura de cada sensor, nas unidades internas
+typedef struct {
+    TipoSensor tipo;
+    uint8_t barramento;   // 0 = i2c0, 1 = i2c1
+    uint8_t endereco;
+    bool valido;          // última leitura bem-sucedida e usada na agregação
+    int32_t temperatura;  // 0.01 °C
+    int32_t valor;        // umidade (0.01 %) no AHT20, pressão (Pa) no BMP280
+    uint32_t leituras;
+    uint32_t falhas;
+
+    // Saúde no barramento (cópia de i2c_health_t, atualizada por arranjo_supervisionar)
+    uint32_t i2c_ok;
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t erros;
+    uint32_t ultimo_ok_ms;  // última leitura boa (ms desde o boot)
+    uint32_t idade_ms;      // tempo desde a última leitura boa
+    bool obsoleto;          // nenhuma leitura boa dentro de ARRANJO_VALIDADE_MS
+} SensorArranjo;
+
+typedef struct {
+    i2c_queue_t *barramentos[ARRANJO_MAX_BARRAMENTOS];
+    uint8_t num_barramentos;
+    AHT20_Dev aht[ARRANJO_MAX_AHT20];
+    Aquisicao aquisicao[ARRANJO_MAX_AHT20];
+    uint8_t num_aht;
+    bmp280_dev_t bmp[ARRANJO_MAX_BMP280];
+    uint8_t num_bmp;
+    Barometro barometro;
+
+    // Sensores em ordem de descoberta: AHT20 primeiro, depois BMP280
+    SensorArranjo sensores[ARRANJO_MAX_SENSORES];
+    uint8_t num_sensores;
+    bool rodada_aht;           // disparo dos AHT20 aguardando coleta
+    uint8_t primeiro_bmp;      // índice em sensores[] do sensor 0 do barômetro
+    uint8_t rodada_bmp;        // bit i: sensor i do barômetro já entregou nesta rodada
+    uint32_t inicio_rodada_bmp_ms;  // primeira entrega da rodada aberta
+    LeituraBarometro leitura_bmp[BAROMETRO_MAX_SENSORES];
+
+    ModoAgregacao modo;
+    int32_t tolerancia_temp;     // 0.01 °C
+    int32_t tolerancia_umid;     // 0.01 %
+    int32_t tolerancia_pressao;  // Pa
+} ArranjoSensores;
+
+// Varre os barramentos em lote, inicializa todo AHT20/BMP280 encontrado e liga a
+// amostragem contínua dos BMP280 no pool dado. Retorna o número de sensores em uso.
+uint8_t arranjo_iniciar(ArranjoSensores *arr, i2c_queue_t *const barramentos[], uint8_t num_barramentos,
+                        bmp280_profile_t perfil, ModoAgregacao modo, alarm_pool_t *pool);
+
+// Dispara a conversão de todos os AHT20 no mesmo tick; false se a rodada anterior não terminou
+bool arranjo_disparar(ArranjoSensores *arr);
+
+// Avança a rodada dos AHT20 sem bloquear; quando todos terminam, grava em *out a
+// umidade/temperatura agregadas (aht_ok = false se nenhum sensor respondeu) e retorna true
+bool arranjo_coletar(ArranjoSensores *arr, AmostraSensores *out);
+
+// Consome os BMP280; retorna true quando uma rodada decimada foi agregada em *out. A rodada
+// fecha quando todos entregam ou meio período de saída depois da primeira entrega: um
+// sensor mudo é marcado como falho sem atrasar os vivos.
+bool arranjo_coletar_barometro(ArranjoSensores *arr, LeituraBarometro *out);
+
+// Vigia os prazos dos barramentos (bus clear quando preciso), copia os contadores de
+// saúde de cada sensor e marca os obsoletos. Chamar periodicamente, fora de interrupção.
+void arranjo_supervisionar(ArranjoSensores *arr, uint32_t agora_ms);
+
+// Combina n valores conforme o modo; retorna quantos valores entraram no resultado
+uint8_t arranjo_agregar(const int32_t *valores, uint8_t n, ModoAgregacao modo, int32_t tolerancia, int32_t *out);
+
+#endif // ARRANJO_H
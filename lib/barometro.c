@@ -0,0 +1,116 @@
+#include "barometro.h"
+
+// Roda em contexto de interrupção ao fim de cada rajada lida do BMP280
+static void barometro_leitura_concluida(i2c_txn_t *txn, void *user) {
+    SensorBarometro *s = (SensorBarometro *)user;
+    AmostraBarometro amostra;
+
+    if (bmp280_get_raw(s->dev, &amostra.raw_temp, &amostra.raw_pressao) != BMP280_OK) {
+        s->perdidas++;
+        return;
+    }
+
+    uint16_t head = s->head;
+    if ((uint16_t)(head - s->tail) >= BAROMETRO_BUFFER) {
+        s->perdidas++;  // consumidor atrasado: descarta a amostra mais nova
+        return;
+    }
+    s->ring[head % BAROMETRO_BUFFER] = amostra;
+    s->head = head + 1;
+}
+
+static bool barometro_timer_callback(repeating_timer_t *rt) {
+    Barometro *b = (Barometro *)rt->user_data;
+    // Apenas enfileira as rajadas; as transferências correm por DMA
+    for (uint8_t i = 0; i < b->num_sensores; i++) {
+        SensorBarometro *s = &b->sensores[i];
+        if (!bmp280_request_raw(s->dev)) {
+            s->perdidas++;
+        }
+    }
+    return true;
+}
+
+static void barometro_reiniciar_janela(SensorBarometro *s) {
+    s->n = 0;
+    s->soma_pressao = 0;
+    s->soma_temp = 0;
+    s->pressao_min = UINT32_MAX;
+    s->pressao_max = 0;
+}
+
+bool barometro_iniciar(Barometro *b, bmp280_dev_t *const devs[], uint8_t num, bmp280_profile_t perfil,
+                       alarm_pool_t *pool) {
+    b->num_sensores = 0;
+    b->pool = pool ? pool : alarm_pool_get_default();
+    b->taxa_hz = BAROMETRO_TAXA_HZ;
+    b->fator = BAROMETRO_TAXA_HZ / BAROMETRO_SAIDA_HZ;
+
+    for (uint8_t i = 0; i < num && b->num_sensores < BAROMETRO_MAX_SENSORES; i++) {
+        if (!bmp280_set_profile(devs[i], perfil)) {
+            continue;
+        }
+        SensorBarometro *s = &b->sensores[b->num_sensores++];
+        s->dev = devs[i];
+        s->head = 0;
+        s->tail = 0;
+        s->perdidas = 0;
+        barometro_reiniciar_janela(s);
+
+        // A partir daqui todas as transações do dispositivo alimentam o buffer
+        devs[i]->txn.callback = barometro_leitura_concluida;
+        devs[i]->txn.user = s;
+    }
+
+    if (b->num_sensores == 0) {
+        return false;
+    }
+    return alarm_pool_add_repeating_timer_us(b->pool, -1000000 / b->taxa_hz, barometro_timer_callback, b, &b->timer);
+}
+
+bool barometro_definir_taxa(Barometro *b, uint16_t taxa_hz, uint32_t saida_ms) {
+    if (b->num_sensores == 0 || taxa_hz == 0) {
+        return false;
+    }
+    uint32_t fator = (uint32_t)taxa_hz * saida_ms / 1000;
+    b->fator = fator < 1 ? 1 : (fator > UINT16_MAX ? UINT16_MAX : (uint16_t)fator);
+    for (uint8_t i = 0; i < b->num_sensores; i++) {
+        barometro_reiniciar_janela(&b->sensores[i]);
+    }
+    if (taxa_hz == b->taxa_hz) {
+        return true;
+    }
+
+    cancel_repeating_timer(&b->timer);
+    b->taxa_hz = taxa_hz;
+    return alarm_pool_add_repeating_timer_us(b->pool, -1000000 / taxa_hz, barometro_timer_callback, b, &b->timer);
+}
+
+bool barometro_decimar(Barometro *b, uint8_t idx, LeituraBarometro *out) {
+    SensorBarometro *s = &b->sensores[idx];
+    bool pronto = false;
+
+    while (s->tail != s->head) {
+        const AmostraBarometro *amostra = &s->ring[s->tail % BAROMETRO_BUFFER];
+        struct bmp280_compensated comp;
+        bmp280_compensate(amostra->raw_temp, amostra->raw_pressao, &s->dev->calib, &comp);
+        s->tail++;
+
+        s->soma_pressao += comp.pressure;
+        s->soma_temp += comp.temperature;
+        if (comp.pressure < s->pressao_min) s->pressao_min = comp.pressure;
+        if (comp.pressure > s->pressao_max) s->pressao_max = comp.pressure;
+
+        if (++s->n >= b->fator) {
+            out->pressao = (uint32_t)((s->soma_pressao + s->n / 2) / s->n);
+            out->temperatura = s->soma_temp / s->n;
+            out->pressao_min = s->pressao_min;
+            out->pressao_max = s->pressao_max;
+            out->amostras = s->n;
+            barometro_reiniciar_janela(s);
+            pronto = true;
+        }
+    }
+
+    return pronto;
+}
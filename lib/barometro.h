@@ -0,0 +1,71 @@
+#ifndef BAROMETRO_H
+#define BAROMETRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "bmp280.h"
+
+// Taxa de amostragem do BMP280 em modo normal e taxa publicada após a decimação
+#define BAROMETRO_TAXA_HZ 25
+#define BAROMETRO_SAIDA_HZ 1
+// Capacidade do buffer circular (potência de 2); ~2,5 s a 25 Hz
+#define BAROMETRO_BUFFER 64
+// Sensores amostrados pelo mesmo timer (dois endereços em cada um dos dois barramentos)
+#define BAROMETRO_MAX_SENSORES 4
+
+// Amostra bruta gravada pelo callback de fim de transação
+typedef struct {
+    int32_t raw_temp;
+    int32_t raw_pressao;
+} AmostraBarometro;
+
+// Valor decimado entregue à interface
+typedef struct {
+    int32_t temperatura;    // 0.01 °C, média da janela
+    uint32_t pressao;       // Pa, média da janela
+    uint32_t pressao_min;   // Pa, extremos da janela (transientes rápidos)
+    uint32_t pressao_max;
+    uint16_t amostras;      // amostras que entraram na média
+} LeituraBarometro;
+
+// Estado de um BMP280: buffer circular e acumuladores da decimação
+typedef struct {
+    bmp280_dev_t *dev;
+
+    // Buffer circular: produtor no callback da fila I2C, consumidor no laço principal
+    AmostraBarometro ring[BAROMETRO_BUFFER];
+    volatile uint16_t head;
+    uint16_t tail;
+    volatile uint32_t perdidas;  // leituras descartadas (buffer cheio, barramento ocupado ou erro)
+
+    uint16_t n;
+    int64_t soma_pressao;
+    int32_t soma_temp;
+    uint32_t pressao_min;
+    uint32_t pressao_max;
+} SensorBarometro;
+
+typedef struct {
+    repeating_timer_t timer;
+    alarm_pool_t *pool;
+    SensorBarometro sensores[BAROMETRO_MAX_SENSORES];
+    uint8_t num_sensores;
+    uint16_t taxa_hz;   // leituras por segundo de cada sensor
+    uint16_t fator;     // leituras por valor decimado
+} Barometro;
+
+// Configura os BMP280 no perfil dado e inicia a amostragem periódica em segundo plano.
+// A cada tick as rajadas de todos os sensores entram juntas nas filas I2C. O timer
+// roda no pool dado (NULL = padrão), que deve ser do mesmo núcleo das filas I2C.
+bool barometro_iniciar(Barometro *b, bmp280_dev_t *const devs[], uint8_t num, bmp280_profile_t perfil,
+                       alarm_pool_t *pool);
+
+// Muda a taxa de leitura e o intervalo das saídas decimadas (amostragem adaptativa).
+// Janelas em andamento são descartadas para não misturar taxas.
+bool barometro_definir_taxa(Barometro *b, uint16_t taxa_hz, uint32_t saida_ms);
+
+// Consome o buffer do sensor idx; retorna true quando uma nova leitura decimada está em *out
+bool barometro_decimar(Barometro *b, uint8_t idx, LeituraBarometro *out);
+
+#endif // BAROMETRO_H
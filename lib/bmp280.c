@@ -1,43 +1,162 @@
 #include "bmp280.h"
 #include "hardware/i2c.h"
 
-#define ADDR _u(0x77)
+static bool bmp280_read_regs(bmp280_dev_t *dev, uint8_t reg, uint8_t *buf, uint8_t len) {
+    dev->tx[0] = reg;
+    i2c_txn_setup(&dev->txn, dev->addr, dev->tx, 1, buf, len);
+    return i2c_queue_transfer(dev->bus, &dev->txn, BMP280_TIMEOUT_US);
+}
+
+static bool bmp280_write_reg(bmp280_dev_t *dev, uint8_t reg, uint8_t val) {
+    dev->tx[0] = reg;
+    dev->tx[1] = val;
+    i2c_txn_setup(&dev->txn, dev->addr, dev->tx, 2, NULL, 0);
+    return i2c_queue_transfer(dev->bus, &dev->txn, BMP280_TIMEOUT_US);
+}
+
+static bool bmp280_get_calib_params(bmp280_dev_t *dev) {
+    uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
+    if (!bmp280_read_regs(dev, REG_DIG_T1_LSB, buf, NUM_CALIB_PARAMS)) {
+        return false;
+    }
+
+    struct bmp280_calib_param *params = &dev->calib;
+    params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0];
+    params->dig_t2 = (int16_t)(buf[3] << 8) | buf[2];
+    params->dig_t3 = (int16_t)(buf[5] << 8) | buf[4];
+
+    params->dig_p1 = (uint16_t)(buf[7] << 8) | buf[6];
+    params->dig_p2 = (int16_t)(buf[9] << 8) | buf[8];
+    params->dig_p3 = (int16_t)(buf[11] << 8) | buf[10];
+    params->dig_p4 = (int16_t)(buf[13] << 8) | buf[12];
+    params->dig_p5 = (int16_t)(buf[15] << 8) | buf[14];
+    params->dig_p6 = (int16_t)(buf[17] << 8) | buf[16];
+    params->dig_p7 = (int16_t)(buf[19] << 8) | buf[18];
+    params->dig_p8 = (int16_t)(buf[21] << 8) | buf[20];
+    params->dig_p9 = (int16_t)(buf[23] << 8) | buf[22];
+    return true;
+}
+
+bool bmp280_init(bmp280_dev_t *dev, i2c_queue_t *bus, uint8_t addr) {
+    dev->bus = bus;
+    dev->addr = addr;
+    dev->chip_id = 0;
+    dev->mode = BMP280_MODE_SLEEP;
+    dev->txn.status = I2C_TXN_IDLE;
+    dev->txn.callback = NULL;
+    dev->txn.user = NULL;
+    dev->txn.retries = BMP280_RETRIES;
+    dev->txn.health = (i2c_health_t){0};
+
+    // Confirma que há um BMP280 no endereço antes de configurá-lo
+    if (!bmp280_read_regs(dev, REG_CHIP_ID, &dev->chip_id, 1) || dev->chip_id != BMP280_CHIP_ID) {
+        return false;
+    }
 
-void bmp280_init(i2c_inst_t *i2c) {
-    uint8_t buf[2];
     const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
-    buf[0] = REG_CONFIG;
-    buf[1] = reg_config_val;
-   
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
-
-    const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
-    buf[0] = REG_CTRL_MEAS;
-    buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
- //   printf("Ctrl_meas register value: %x\n", reg_ctrl_meas_val);
+    if (!bmp280_write_reg(dev, REG_CONFIG, reg_config_val)) {
+        return false;
+    }
+
+    // Sensor fica em sleep; cada amostra é disparada em modo forçado
+    dev->ctrl_meas = (0x01 << 5) | (0x03 << 2);
+    if (!bmp280_write_reg(dev, REG_CTRL_MEAS, dev->ctrl_meas | BMP280_MODE_SLEEP)) {
+        return false;
+    }
+
+    // A calibração é gravada de fábrica e não muda: lida uma única vez aqui
+    return bmp280_get_calib_params(dev);
+}
+
+// Perfis de oversampling, filtro IIR e standby (códigos de campo do datasheet)
+static const struct {
+    uint8_t osrs_t;
+    uint8_t osrs_p;
+    uint8_t filter;
+    uint8_t t_sb;
+} bmp280_profiles[] = {
+    [BMP280_PROFILE_ULTRA_LOW_POWER] = { 0x01, 0x01, 0x00, 0x01 },  // T x1, P x1, IIR off, 62.5 ms: ~14 Hz
+    [BMP280_PROFILE_STANDARD]        = { 0x01, 0x03, 0x02, 0x00 },  // T x1, P x4, IIR 4, 0.5 ms: ~72 Hz
+    [BMP280_PROFILE_HIGH_RES]        = { 0x02, 0x05, 0x04, 0x00 },  // T x2, P x16, IIR 16, 0.5 ms: ~23 Hz
+};
+
+bool bmp280_set_profile(bmp280_dev_t *dev, bmp280_profile_t profile) {
+    if (profile > BMP280_PROFILE_HIGH_RES) {
+        return false;
+    }
+
+    // O REG_CONFIG só é aceito de forma confiável com o sensor em sleep
+    if (!bmp280_write_reg(dev, REG_CTRL_MEAS, dev->ctrl_meas | BMP280_MODE_SLEEP)) {
+        return false;
+    }
+
+    const uint8_t reg_config_val = (bmp280_profiles[profile].t_sb << 5) | (bmp280_profiles[profile].filter << 2);
+    dev->ctrl_meas = (bmp280_profiles[profile].osrs_t << 5) | (bmp280_profiles[profile].osrs_p << 2);
+    if (!bmp280_write_reg(dev, REG_CONFIG, reg_config_val) ||
+        !bmp280_write_reg(dev, REG_CTRL_MEAS, dev->ctrl_meas | BMP280_MODE_NORMAL)) {
+        return false;
+    }
+    dev->mode = BMP280_MODE_NORMAL;
+    return true;
 }
 
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
+bool bmp280_read_raw(bmp280_dev_t *dev, int32_t* temp, int32_t* pressure) {
     uint8_t buf[6];
-    uint8_t reg = REG_PRESSURE_MSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, 6, false);
+    if (!bmp280_read_regs(dev, REG_PRESSURE_MSB, buf, 6)) {
+        return false;
+    }
 
     *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
     *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
+    return true;
+}
+
+void bmp280_reset(bmp280_dev_t *dev) {
+    bmp280_write_reg(dev, REG_RESET, 0xB6);
+}
 
+bool bmp280_start_measurement(bmp280_dev_t *dev) {
+    if (i2c_txn_pending(&dev->txn)) {
+        return false;
+    }
+    dev->tx[0] = REG_CTRL_MEAS;
+    dev->tx[1] = dev->ctrl_meas | BMP280_MODE_FORCED;
+    i2c_txn_setup(&dev->txn, dev->addr, dev->tx, 2, NULL, 0);
+    return i2c_queue_submit(dev->bus, &dev->txn);
+}
 
+bool bmp280_request_raw(bmp280_dev_t *dev) {
+    if (i2c_txn_pending(&dev->txn)) {
+        return false;
+    }
+    // Status (0xF3) e dados (0xF7..0xFC) são lidos na mesma rajada
+    dev->tx[0] = REG_STATUS;
+    i2c_txn_setup(&dev->txn, dev->addr, dev->tx, 1, dev->rx, BMP280_BURST_LEN);
+    return i2c_queue_submit(dev->bus, &dev->txn);
 }
 
-void bmp280_reset(i2c_inst_t *i2c) {
-    uint8_t buf[2] = { REG_RESET, 0xB6 };
-    i2c_write_blocking(i2c, ADDR, buf, 2, false);
+bool bmp280_busy(const bmp280_dev_t *dev) {
+    return i2c_txn_pending(&dev->txn);
+}
+
+bmp280_status_t bmp280_get_raw(const bmp280_dev_t *dev, int32_t* temp, int32_t* pressure) {
+    if (dev->txn.status != I2C_TXN_OK) {
+        return BMP280_ERROR;
+    }
+    // Em modo normal os registradores de dados são sombreados e sempre contêm a última conversão completa
+    if (dev->mode != BMP280_MODE_NORMAL && (dev->rx[0] & BMP280_STATUS_MEASURING)) {
+        return BMP280_BUSY;
+    }
+
+    const uint8_t *buf = &dev->rx[REG_PRESSURE_MSB - REG_STATUS];
+    *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
+    *temp = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
+    return BMP280_OK;
 }
 
 // função intermediária que calcula a temperatura de resolução fina
 // usada tanto para conversões de pressão quanto de temperatura
-int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
+static int32_t bmp280_convert(int32_t temp, const struct bmp280_calib_param* params) {
     // usa os 32 bits de compensação de ponto fixo implementados no datasheet
     int32_t var1, var2;
     var1 = ((((temp >> 3) - ((int32_t)params->dig_t1 << 1))) * ((int32_t)params->dig_t2)) >> 11;
@@ -45,20 +164,11 @@ int32_t bmp280_convert(int32_t temp, struct bmp280_calib_param* params) {
     return var1 + var2;
 }
 
-int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de temperatura lido de seus registradores
-    int32_t t_fine = bmp280_convert(temp, params);
-    return (t_fine * 5 + 128) >> 8;
-}
-
-
-int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params) {
-    // Utiliza os parâmetros de calibração do BMP280 para compensar o valor de pressão lido de seus registradores
-
-    int32_t t_fine = bmp280_convert(temp, params);
-
+#if !BMP280_PRESSURE_64BIT
+// Fórmula de 32 bits do datasheet; resultado em Pa
+static uint32_t bmp280_convert_pressure_32(int32_t pressure, int32_t t_fine, const struct bmp280_calib_param* params) {
     int32_t var1, var2;
-    uint32_t converted = 0.0;
+    uint32_t converted = 0;
     var1 = (((int32_t)t_fine) >> 1) - (int32_t)64000;
     var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * ((int32_t)params->dig_p6);
     var2 += ((var1 * ((int32_t)params->dig_p5)) << 1);
@@ -79,26 +189,38 @@ int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_ca
     converted = (uint32_t)((int32_t)converted + ((var1 + var2 + params->dig_p7) >> 4));
     return converted;
 }
-
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
-    uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
-    uint8_t reg = REG_DIG_T1_LSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, NUM_CALIB_PARAMS, false);
-
-    params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0];
-    params->dig_t2 = (int16_t)(buf[3] << 8) | buf[2];
-    params->dig_t3 = (int16_t)(buf[5] << 8) | buf[4];
-
-    params->dig_p1 = (uint16_t)(buf[7] << 8) | buf[6];
-    params->dig_p2 = (int16_t)(buf[9] << 8) | buf[8];
-    params->dig_p3 = (int16_t)(buf[11] << 8) | buf[10];
-    params->dig_p4 = (int16_t)(buf[13] << 8) | buf[12];
-    params->dig_p5 = (int16_t)(buf[15] << 8) | buf[14];
-    params->dig_p6 = (int16_t)(buf[17] << 8) | buf[16];
-    params->dig_p7 = (int16_t)(buf[19] << 8) | buf[18];
-    params->dig_p8 = (int16_t)(buf[21] << 8) | buf[20];
-    params->dig_p9 = (int16_t)(buf[23] << 8) | buf[22];
-
-
+#else
+// Fórmula de 64 bits do datasheet; resultado em Pa/256 (Q24.8)
+static uint32_t bmp280_convert_pressure_64(int32_t pressure, int32_t t_fine, const struct bmp280_calib_param* params) {
+    int64_t var1, var2, p;
+    var1 = ((int64_t)t_fine) - 128000;
+    var2 = var1 * var1 * (int64_t)params->dig_p6;
+    var2 = var2 + ((var1 * (int64_t)params->dig_p5) << 17);
+    var2 = var2 + (((int64_t)params->dig_p4) << 35);
+    var1 = ((var1 * var1 * (int64_t)params->dig_p3) >> 8) + ((var1 * (int64_t)params->dig_p2) << 12);
+    var1 = (((((int64_t)1) << 47) + var1)) * ((int64_t)params->dig_p1) >> 33;
+    if (var1 == 0) {
+        return 0;  // evita divisão por zero
+    }
+    p = 1048576 - pressure;
+    p = (((p << 31) - var2) * 3125) / var1;
+    var1 = (((int64_t)params->dig_p9) * (p >> 13) * (p >> 13)) >> 25;
+    var2 = (((int64_t)params->dig_p8) * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (((int64_t)params->dig_p7) << 4);
+    return (uint32_t)p;
+}
+#endif
+
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, struct bmp280_compensated* out) {
+    // t_fine é calculado uma única vez e reaproveitado na compensação da pressão
+    int32_t t_fine = bmp280_convert(raw_t, params);
+    out->temperature = (t_fine * 5 + 128) >> 8;
+
+#if BMP280_PRESSURE_64BIT
+    out->pressure_q8 = bmp280_convert_pressure_64(raw_p, t_fine, params);
+    out->pressure = (out->pressure_q8 + 128) >> 8;
+#else
+    out->pressure = bmp280_convert_pressure_32(raw_p, t_fine, params);
+    out->pressure_q8 = out->pressure << 8;
+#endif
 }
@@ -2,12 +2,27 @@
 #define BMP280_H
 
 #include "hardware/i2c.h"
+#include "i2c_queue.h"
 
-// Defina os endereços e registros conforme o código original
-#define ADDR _u(0x77)
+// Seleciona a fórmula de pressão de 64 bits do datasheet (resolução de Pa/256, a menos
+// de 0,3 Pa da fórmula em double). A de 32 bits é mais barata no Cortex-M0+ e resolve
+// 1 Pa, mas seus truncamentos a afastam até ~6 Pa da fórmula em double (test/teste_bmp280.c).
+#ifndef BMP280_PRESSURE_64BIT
+#define BMP280_PRESSURE_64BIT 0
+#endif
+
+// Endereços I2C possíveis do BMP280 (pino SDO em GND ou VDDIO)
+#define BMP280_I2C_ADDR_PRIM _u(0x76)
+#define BMP280_I2C_ADDR_SEC _u(0x77)
+#define BMP280_I2C_ADDR BMP280_I2C_ADDR_SEC
+
+// Identificação do chip
+#define REG_CHIP_ID _u(0xD0)
+#define BMP280_CHIP_ID _u(0x58)
 
 #define REG_CONFIG _u(0xF5)
 #define REG_CTRL_MEAS _u(0xF4)
+#define REG_STATUS _u(0xF3)
 #define REG_RESET _u(0xE0)
 
 #define REG_TEMP_XLSB _u(0xFC)
@@ -45,6 +60,32 @@
 
 #define NUM_CALIB_PARAMS 24
 
+// Bits de modo do REG_CTRL_MEAS e status
+#define BMP280_MODE_SLEEP _u(0x00)
+#define BMP280_MODE_FORCED _u(0x01)
+#define BMP280_MODE_NORMAL _u(0x03)
+#define BMP280_STATUS_MEASURING _u(0x08)
+
+// Rajada de REG_STATUS (0xF3) até REG_TEMP_XLSB (0xFC)
+#define BMP280_BURST_LEN 10
+// Limite para transações bloqueantes (inicialização)
+#define BMP280_TIMEOUT_US 10000
+// Retentativas da fila por transação; uma rajada perdida ainda conta em perdidas
+#define BMP280_RETRIES 1
+
+// Perfis de operação contínua (modo normal) com filtro IIR
+typedef enum {
+    BMP280_PROFILE_ULTRA_LOW_POWER,
+    BMP280_PROFILE_STANDARD,
+    BMP280_PROFILE_HIGH_RES
+} bmp280_profile_t;
+
+typedef enum {
+    BMP280_OK,
+    BMP280_BUSY,
+    BMP280_ERROR
+} bmp280_status_t;
+
 struct bmp280_calib_param {
     uint16_t dig_t1;
     int16_t dig_t2;
@@ -61,12 +102,43 @@ struct bmp280_calib_param {
     int16_t dig_p9;
 };
 
-//void bmp280_init(void);
-void bmp280_init(i2c_inst_t *i2c);
-void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure);
-void bmp280_reset(i2c_inst_t *i2c);
-int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
-int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
-void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
+// Resultado compensado de uma leitura
+struct bmp280_compensated {
+    int32_t temperature;   // 0.01 °C
+    uint32_t pressure;     // Pa
+    uint32_t pressure_q8;  // Pa/256 (resolução fracionária só no modo de 64 bits)
+};
+
+// Contexto do dispositivo: barramento, endereço e calibração lida uma única vez no init
+typedef struct {
+    i2c_queue_t *bus;
+    uint8_t addr;
+    uint8_t chip_id;
+    uint8_t ctrl_meas;   // oversampling configurado, sem os bits de modo
+    uint8_t mode;        // BMP280_MODE_SLEEP (disparo forçado) ou BMP280_MODE_NORMAL
+    struct bmp280_calib_param calib;
+    // Descritor e buffers da transação em andamento na fila I2C
+    i2c_txn_t txn;
+    uint8_t tx[2];
+    uint8_t rx[BMP280_BURST_LEN];
+} bmp280_dev_t;
+
+// Verifica o chip ID, configura o sensor e armazena os parâmetros de calibração em dev
+bool bmp280_init(bmp280_dev_t *dev, i2c_queue_t *bus, uint8_t addr);
+// Lê temperatura e pressão brutas em uma única leitura em rajada (0xF7..0xFC)
+bool bmp280_read_raw(bmp280_dev_t *dev, int32_t* temp, int32_t* pressure);
+void bmp280_reset(bmp280_dev_t *dev);
+// Coloca o sensor em modo normal com o perfil de oversampling/IIR/standby escolhido
+bool bmp280_set_profile(bmp280_dev_t *dev, bmp280_profile_t profile);
+// Dispara uma conversão em modo forçado e retorna imediatamente
+bool bmp280_start_measurement(bmp280_dev_t *dev);
+// Enfileira a leitura em rajada de status e dados brutos e retorna imediatamente
+bool bmp280_request_raw(bmp280_dev_t *dev);
+// true enquanto a última transação enfileirada não terminou
+bool bmp280_busy(const bmp280_dev_t *dev);
+// Interpreta a última rajada: BMP280_BUSY enquanto a conversão ainda está em andamento
+bmp280_status_t bmp280_get_raw(const bmp280_dev_t *dev, int32_t* temp, int32_t* pressure);
+// Compensa temperatura e pressão em uma só passada (t_fine calculado uma vez)
+void bmp280_compensate(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param* params, struct bmp280_compensated* out);
 
 #endif
@@ -0,0 +1,167 @@
+#include "buzzer.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+
+// Divisor fixo do PWM: com clk_sys de 125 MHz o wrap cabe em 16 bits a partir de ~96 Hz
+#define BUZZER_DIVISOR 20
+#define BUZZER_CLK_HZ 125000000
+
+static void buzzer_tom(Buzzer *bz, uint16_t frequencia) {
+    if (frequencia == 0) {
+        pwm_set_gpio_level(bz->pino, 0);
+        return;
+    }
+    uint16_t wrap = (BUZZER_CLK_HZ / ((uint32_t)frequencia * BUZZER_DIVISOR)) - 1;
+    pwm_set_wrap(bz->slice, wrap);
+    pwm_set_gpio_level(bz->pino, wrap / 2);
+}
+
+static int64_t buzzer_alarme(alarm_id_t id, void *user);
+
+// Chamadas com interrupções desabilitadas (ou dentro do alarme)
+static void buzzer_agendar(Buzzer *bz, uint32_t atraso_ms) {
+    // Atraso zero dispararia o alarme antes de bz->alarme ser gravado
+    if (atraso_ms == 0) {
+        atraso_ms = 1;
+    }
+    alarm_id_t id = alarm_pool_add_alarm_in_ms(bz->pool, atraso_ms, buzzer_alarme, bz, true);
+    if (id <= 0) {
+        // Pool sem alarmes livres: sem quem desligue a nota, o tom ficaria preso.
+        // Silencia e abandona o padrão e a fila.
+        buzzer_tom(bz, 0);
+        bz->descartados += bz->num_fila + (bz->atual != NULL);
+        bz->atual = NULL;
+        bz->num_fila = 0;
+        bz->alarme = 0;
+        bz->falhas_alarme++;
+        return;
+    }
+    bz->alarme = id;
+}
+
+static void buzzer_iniciar_nota(Buzzer *bz) {
+    const Nota *n = &bz->atual->notas[bz->nota];
+    bz->em_pausa = false;
+    buzzer_tom(bz, n->frequencia);
+    buzzer_agendar(bz, n->duracao_ms);
+}
+
+static void buzzer_proximo_padrao(Buzzer *bz) {
+    if (bz->num_fila == 0) {
+        bz->atual = NULL;
+        bz->alarme = 0;
+        buzzer_tom(bz, 0);
+        return;
+    }
+    bz->atual = bz->fila[0].padrao;
+    bz->prioridade = bz->fila[0].prioridade;
+    for (uint8_t i = 1; i < bz->num_fila; i++) {
+        bz->fila[i - 1] = bz->fila[i];
+    }
+    bz->num_fila--;
+    bz->nota = 0;
+    bz->repeticao = 0;
+    buzzer_iniciar_nota(bz);
+}
+
+// Avança a sequência: fim da nota -> pausa -> próxima nota/repetição/padrão
+static int64_t buzzer_alarme(alarm_id_t id, void *user) {
+    Buzzer *bz = (Buzzer *)user;
+    if (!bz->atual || id != bz->alarme) {
+        return 0;  // alarme de um padrão já interrompido
+    }
+
+    const PadraoSom *p = bz->atual;
+    if (!bz->em_pausa && p->notas[bz->nota].pausa_ms) {
+        bz->em_pausa = true;
+        buzzer_tom(bz, 0);
+        buzzer_agendar(bz, p->notas[bz->nota].pausa_ms);
+        return 0;
+    }
+
+    if (++bz->nota >= p->num_notas) {
+        bz->nota = 0;
+        uint8_t total = p->repeticoes ? p->repeticoes : 1;
+        if (++bz->repeticao >= total) {
+            buzzer_proximo_padrao(bz);
+            return 0;
+        }
+    }
+    buzzer_iniciar_nota(bz);
+    return 0;
+}
+
+void buzzer_init(Buzzer *bz, uint pino, alarm_pool_t *pool) {
+    bz->pino = pino;
+    bz->slice = pwm_gpio_to_slice_num(pino);
+    bz->pool = pool ? pool : alarm_pool_get_default();
+    bz->alarme = 0;
+    bz->atual = NULL;
+    bz->num_fila = 0;
+    bz->descartados = 0;
+    bz->falhas_alarme = 0;
+
+    gpio_set_function(pino, GPIO_FUNC_PWM);
+    pwm_config config = pwm_get_default_config();
+    pwm_init(bz->slice, &config, true);
+    pwm_set_clkdiv_int_frac(bz->slice, BUZZER_DIVISOR, 0);
+    pwm_set_gpio_level(pino, 0);
+}
+
+bool buzzer_tocar(Buzzer *bz, const PadraoSom *padrao, PrioridadeSom prioridade) {
+    if (!padrao || padrao->num_notas == 0) {
+        return false;
+    }
+
+    bool aceito = true;
+    uint32_t irq = save_and_disable_interrupts();
+
+    if (bz->atual && prioridade > bz->prioridade) {
+        // Preempção: o padrão interrompido é abandonado (cliques não fazem sentido atrasados)
+        alarm_pool_cancel_alarm(bz->pool, bz->alarme);
+        bz->atual = NULL;
+    }
+
+    // Insere depois de todos de prioridade maior ou igual
+    uint8_t pos = 0;
+    while (pos < bz->num_fila && bz->fila[pos].prioridade >= prioridade) {
+        pos++;
+    }
+    if (bz->num_fila == BUZZER_FILA) {
+        if (pos == BUZZER_FILA) {
+            aceito = false;  // todos na fila têm prioridade maior ou igual
+        } else {
+            bz->num_fila--;  // descarta o último (o de menor prioridade)
+        }
+        bz->descartados++;
+    }
+    if (aceito) {
+        for (uint8_t i = bz->num_fila; i > pos; i--) {
+            bz->fila[i] = bz->fila[i - 1];
+        }
+        bz->fila[pos] = (PedidoSom){padrao, prioridade};
+        bz->num_fila++;
+    }
+
+    if (!bz->atual) {
+        buzzer_proximo_padrao(bz);
+    }
+    restore_interrupts(irq);
+    return aceito;
+}
+
+void buzzer_parar(Buzzer *bz) {
+    uint32_t irq = save_and_disable_interrupts();
+    if (bz->atual) {
+        alarm_pool_cancel_alarm(bz->pool, bz->alarme);
+    }
+    bz->atual = NULL;
+    bz->num_fila = 0;
+    bz->alarme = 0;
+    buzzer_tom(bz, 0);
+    restore_interrupts(irq);
+}
+
+bool buzzer_ocupado(const Buzzer *bz) {
+    return bz->atual != NULL;
+}
@@ -0,0 +1,68 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Padrões aguardando a vez (o que está tocando não conta)
+#define BUZZER_FILA 4
+
+// Uma nota: frequência 0 é silêncio
+typedef struct {
+    uint16_t frequencia;   // Hz
+    uint16_t duracao_ms;
+    uint16_t pausa_ms;     // silêncio depois da nota
+} Nota;
+
+typedef struct {
+    const Nota *notas;
+    uint8_t num_notas;
+    uint8_t repeticoes;    // vezes que a sequência toca (0 = 1)
+} PadraoSom;
+
+// Prioridade maior interrompe o que estiver tocando
+typedef enum {
+    SOM_CLIQUE,
+    SOM_AVISO,
+    SOM_ALERTA
+} PrioridadeSom;
+
+typedef struct {
+    const PadraoSom *padrao;
+    PrioridadeSom prioridade;
+} PedidoSom;
+
+typedef struct {
+    uint pino;
+    uint slice;
+    alarm_pool_t *pool;
+    alarm_id_t alarme;
+
+    // Padrão em execução
+    const PadraoSom *atual;
+    PrioridadeSom prioridade;
+    uint8_t nota;
+    uint8_t repeticao;
+    bool em_pausa;
+
+    // Fila ordenada por prioridade (maior primeiro, ordem de chegada dentro da mesma)
+    PedidoSom fila[BUZZER_FILA];
+    uint8_t num_fila;
+    uint32_t descartados;
+    uint32_t falhas_alarme;  // alarme recusado pelo pool: padrão e fila abandonados
+} Buzzer;
+
+// Configura o PWM do pino; os alarmes do sequenciador rodam no pool dado (NULL = padrão)
+void buzzer_init(Buzzer *bz, uint pino, alarm_pool_t *pool);
+
+// Enfileira o padrão e retorna imediatamente; o padrão precisa continuar válido
+// enquanto toca. Retorna false se foi descartado (fila cheia de prioridade maior ou igual).
+bool buzzer_tocar(Buzzer *bz, const PadraoSom *padrao, PrioridadeSom prioridade);
+
+// Interrompe o som atual e esvazia a fila
+void buzzer_parar(Buzzer *bz);
+
+bool buzzer_ocupado(const Buzzer *bz);
+
+#endif // BUZZER_H
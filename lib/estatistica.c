@@ -0,0 +1,188 @@
+#include "estatistica.h"
+
+static int32_t mediana_inserir(FiltroMediana *f, int32_t x) {
+    uint8_t n = f->n;
+
+    // Remove do vetor ordenado a amostra que sai da janela
+    if (n == ESTAT_MEDIANA_N) {
+        int32_t sai = f->historico[f->pos];
+        uint8_t i = 0;
+        while (f->ordenado[i] != sai) i++;
+        for (; i < n - 1; i++) f->ordenado[i] = f->ordenado[i + 1];
+        n--;
+    }
+
+    // Insere a nova amostra mantendo a ordem
+    uint8_t i = n;
+    while (i > 0 && f->ordenado[i - 1] > x) {
+        f->ordenado[i] = f->ordenado[i - 1];
+        i--;
+    }
+    f->ordenado[i] = x;
+    n++;
+
+    f->historico[f->pos] = x;
+    f->pos = (f->pos + 1) % ESTAT_MEDIANA_N;
+    f->n = n;
+    return f->ordenado[n / 2];
+}
+
+static void bloco_limpar(BlocoEstat *b) {
+    b->n = 0;
+    b->ref = 0;
+    b->soma = 0;
+    b->soma_quad = 0;
+    b->min = INT32_MAX;
+    b->max = INT32_MIN;
+}
+
+static void janela_init(JanelaEstat *j, uint8_t num_blocos, uint32_t duracao_bloco_ms) {
+    j->num_blocos = num_blocos;
+    j->duracao_bloco_ms = duracao_bloco_ms;
+    j->atual = 0;
+    j->iniciada = false;
+    for (uint8_t i = 0; i < num_blocos; i++) {
+        bloco_limpar(&j->blocos[i]);
+    }
+}
+
+static void janela_adicionar(JanelaEstat *j, int32_t x, uint32_t t_ms) {
+    if (!j->iniciada) {
+        j->inicio_bloco_ms = t_ms;
+        j->iniciada = true;
+    }
+
+    // Um bloco por período vencido: o mais antigo é reaproveitado e sai da janela
+    uint8_t avancos = 0;
+    while (t_ms - j->inicio_bloco_ms >= j->duracao_bloco_ms && avancos < j->num_blocos) {
+        j->atual = (j->atual + 1) % j->num_blocos;
+        bloco_limpar(&j->blocos[j->atual]);
+        j->inicio_bloco_ms += j->duracao_bloco_ms;
+        avancos++;
+    }
+    if (avancos == j->num_blocos) {
+        j->inicio_bloco_ms = t_ms;  // pausa maior que a janela inteira: recomeça daqui
+    }
+
+    BlocoEstat *b = &j->blocos[j->atual];
+    if (b->n == 0) {
+        b->ref = x;
+    }
+    int64_t d = (int64_t)x - b->ref;
+    b->n++;
+    b->soma += d;
+    b->soma_quad += d * d;
+    if (x < b->min) b->min = x;
+    if (x > b->max) b->max = x;
+}
+
+static uint32_t raiz_inteira(uint64_t v) {
+    uint64_t r = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+
+// Desloca as somas de um bloco para a referência ref: com d = b->ref - ref,
+// Σ(x-ref) = Σ(x-b->ref) + n·d e Σ(x-ref)² = Σ(x-b->ref)² + 2·d·Σ(x-b->ref) + n·d²
+static void bloco_acumular(BlocoEstat *total, const BlocoEstat *b) {
+    int64_t d = (int64_t)b->ref - total->ref;
+    int64_t n = b->n;
+    total->n += b->n;
+    total->soma += b->soma + n * d;
+    total->soma_quad += b->soma_quad + 2 * d * b->soma + n * d * d;
+    if (b->min < total->min) total->min = b->min;
+    if (b->max > total->max) total->max = b->max;
+}
+
+static void janela_resumo(const JanelaEstat *j, ResumoEstat *out) {
+    BlocoEstat total;
+    bloco_limpar(&total);
+    for (uint8_t i = 0; i < j->num_blocos; i++) {
+        const BlocoEstat *b = &j->blocos[i];
+        if (b->n == 0) continue;
+        if (total.n == 0) {
+            total.ref = b->ref;
+        }
+        bloco_acumular(&total, b);
+    }
+
+    out->n = total.n;
+    if (total.n == 0) {
+        out->media = out->desvio = out->min = out->max = 0;
+        return;
+    }
+    int64_t n = total.n;
+    int64_t meia = (total.soma >= 0 ? n : -n) / 2;
+    out->media = (int32_t)(total.ref + (total.soma + meia) / n);
+    out->min = total.min;
+    out->max = total.max;
+    // Recentrada na média arredondada, |Σ(x-média)| <= n/2 e Σ(x-média)² ≈ (n-1)·s²:
+    // nada cresce com o valor absoluto das amostras. s² = (Σd² - (Σd)²/n) / (n-1).
+    if (n > 1) {
+        BlocoEstat centro;
+        bloco_limpar(&centro);
+        centro.ref = out->media;
+        bloco_acumular(&centro, &total);
+        int64_t s = centro.soma;
+        int64_t m2 = centro.soma_quad - (s * s + n / 2) / n;
+        out->desvio = (int32_t)raiz_inteira((uint64_t)(m2 > 0 ? m2 : 0) / (uint64_t)(n - 1));
+    } else {
+        out->desvio = 0;
+    }
+}
+
+void canal_estat_init(CanalEstat *c, int32_t limiar_espuria) {
+    c->mediana.pos = 0;
+    c->mediana.n = 0;
+    c->limiar_espuria = limiar_espuria;
+    c->espurias = 0;
+    // 1 min em 6 blocos de 10 s; 10 min em 10 blocos de 1 min
+    janela_init(&c->janela_1min, 6, 10000);
+    janela_init(&c->janela_10min, 10, 60000);
+}
+
+int32_t canal_estat_atualizar(CanalEstat *c, int32_t bruta, uint32_t t_ms) {
+    int32_t filtrada = mediana_inserir(&c->mediana, bruta);
+    int32_t desvio = bruta - filtrada;
+    if (desvio > c->limiar_espuria || -desvio > c->limiar_espuria) {
+        c->espurias++;
+    }
+    janela_adicionar(&c->janela_1min, filtrada, t_ms);
+    janela_adicionar(&c->janela_10min, filtrada, t_ms);
+    return filtrada;
+}
+
+static void janela_deslocar(JanelaEstat *j, int32_t delta) {
+    // As somas são relativas a ref: só a referência e os extremos mudam
+    for (uint8_t i = 0; i < j->num_blocos; i++) {
+        BlocoEstat *b = &j->blocos[i];
+        if (b->n) {
+            b->ref += delta;
+            b->min += delta;
+            b->max += delta;
+        }
+    }
+}
+
+void canal_estat_deslocar(CanalEstat *c, int32_t delta) {
+    for (uint8_t i = 0; i < c->mediana.n; i++) {
+        c->mediana.historico[i] += delta;
+        c->mediana.ordenado[i] += delta;
+    }
+    janela_deslocar(&c->janela_1min, delta);
+    janela_deslocar(&c->janela_10min, delta);
+}
+
+void canal_estat_resumo(const CanalEstat *c, IdJanela janela, ResumoEstat *out) {
+    janela_resumo(janela == JANELA_1MIN ? &c->janela_1min : &c->janela_10min, out);
+}
@@ -0,0 +1,80 @@
+#ifndef ESTATISTICA_H
+#define ESTATISTICA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Tamanho do filtro de mediana (ímpar); rejeita até (N-1)/2 amostras espúrias seguidas
+#define ESTAT_MEDIANA_N 5
+// Maior número de blocos em uma janela deslizante
+#define ESTAT_MAX_BLOCOS 10
+
+// Filtro de mediana incremental: mantém as N últimas amostras ordenadas
+typedef struct {
+    int32_t historico[ESTAT_MEDIANA_N];  // ordem de chegada
+    int32_t ordenado[ESTAT_MEDIANA_N];
+    uint8_t pos;
+    uint8_t n;
+} FiltroMediana;
+
+// Agregado de um bloco de amostras. As somas são dos desvios em relação à primeira
+// amostra do bloco (ref): ficam pequenas mesmo para pressão em Pa, exatas em 64 bits
+// a qualquer taxa, e sem as divisões por amostra do Welford. Os blocos são somados
+// deslocando cada um para uma referência comum.
+typedef struct {
+    uint32_t n;
+    int32_t ref;
+    int64_t soma;
+    int64_t soma_quad;
+    int32_t min;
+    int32_t max;
+} BlocoEstat;
+
+// Janela deslizante formada por blocos consecutivos de duração fixa; avança um bloco
+// por vez, cobrindo entre (blocos-1)*duracao_bloco_ms e blocos*duracao_bloco_ms. Por
+// ser medida em tempo, continua valendo quando a taxa de amostragem muda.
+typedef struct {
+    BlocoEstat blocos[ESTAT_MAX_BLOCOS];
+    uint8_t num_blocos;
+    uint8_t atual;
+    bool iniciada;
+    uint32_t duracao_bloco_ms;
+    uint32_t inicio_bloco_ms;
+} JanelaEstat;
+
+// Resumo de uma janela nas mesmas unidades das amostras
+typedef struct {
+    uint32_t n;
+    int32_t media;
+    int32_t desvio;  // desvio padrão amostral
+    int32_t min;
+    int32_t max;
+} ResumoEstat;
+
+typedef enum {
+    JANELA_1MIN,
+    JANELA_10MIN,
+    NUM_JANELAS
+} IdJanela;
+
+// Estatísticas de um canal: filtro de mediana seguido de janelas de 1 e 10 min
+typedef struct {
+    FiltroMediana mediana;
+    JanelaEstat janela_1min;
+    JanelaEstat janela_10min;
+    int32_t limiar_espuria;   // |bruta - mediana| acima disto conta como espúria
+    uint32_t espurias;
+} CanalEstat;
+
+void canal_estat_init(CanalEstat *c, int32_t limiar_espuria);
+
+// Insere uma amostra bruta colhida em t_ms e retorna o valor filtrado (O(1) para N fixo)
+int32_t canal_estat_atualizar(CanalEstat *c, int32_t bruta, uint32_t t_ms);
+
+void canal_estat_resumo(const CanalEstat *c, IdJanela janela, ResumoEstat *out);
+
+// Soma delta a tudo o que o canal guardou (filtro e janelas), como se as amostras
+// passadas já tivessem chegado com o novo offset de calibração
+void canal_estat_deslocar(CanalEstat *c, int32_t delta);
+
+#endif // ESTATISTICA_H
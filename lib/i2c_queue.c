@@ -0,0 +1,220 @@
+#include <string.h>
+#include "i2c_queue.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Chamadas com interrupções desabilitadas
+static void i2c_queue_start_atual(i2c_queue_t *q) {
+    q->inicio_us = time_us_64();
+    q->prazo_us = I2C_QUEUE_DEADLINE_US;
+    if (q->atual->stream) {
+        q->prazo_us += (uint32_t)q->atual->stream_len * I2C_QUEUE_STREAM_US_PER_WORD;
+    }
+    q->start(q, q->atual);
+}
+
+static void i2c_queue_start_next(i2c_queue_t *q) {
+    if (q->atual || q->count == 0 || q->reservada || q->recuperar) {
+        return;
+    }
+    q->atual = q->fila[q->head];
+    q->head = (q->head + 1) % I2C_QUEUE_SIZE;
+    q->count--;
+    i2c_queue_start_atual(q);
+}
+
+static void i2c_queue_contabilizar(i2c_txn_t *txn, i2c_txn_status_t status) {
+    i2c_health_t *h = &txn->health;
+    switch (status) {
+        case I2C_TXN_OK:
+            h->ok++;
+            h->last_ok_us = time_us_64();
+            break;
+        case I2C_TXN_NACK:    h->nacks++; break;
+        case I2C_TXN_TIMEOUT: h->timeouts++; break;
+        default:              h->errors++; break;
+    }
+}
+
+bool i2c_queue_submit(i2c_queue_t *q, i2c_txn_t *txn) {
+    if (txn->stream) {
+        if (txn->stream_len == 0) {
+            return false;
+        }
+    } else if (txn->tx_len + txn->rx_len == 0 || txn->tx_len + txn->rx_len > I2C_QUEUE_MAX_LEN) {
+        return false;
+    }
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (txn->status == I2C_TXN_PENDING || q->count == I2C_QUEUE_SIZE) {
+        restore_interrupts(irq);
+        return false;
+    }
+    txn->status = I2C_TXN_PENDING;
+    txn->attempt = 0;
+    q->fila[(q->head + q->count) % I2C_QUEUE_SIZE] = txn;
+    q->count++;
+    i2c_queue_start_next(q);
+    restore_interrupts(irq);
+    return true;
+}
+
+void i2c_queue_complete(i2c_queue_t *q, i2c_txn_status_t status) {
+    uint32_t irq = save_and_disable_interrupts();
+    i2c_txn_t *txn = q->atual;
+    if (txn) {
+        i2c_queue_contabilizar(txn, status);
+    }
+    if (txn && status != I2C_TXN_OK && txn->attempt < txn->retries && q->retry_budget) {
+        // Repete na hora; com bus clear pendente ela fica como atual até a recuperação
+        txn->attempt++;
+        txn->health.retries++;
+        q->retry_budget--;
+        if (!q->recuperar) {
+            i2c_queue_start_atual(q);
+        }
+        restore_interrupts(irq);
+        return;
+    }
+    q->atual = NULL;
+    if (txn) {
+        txn->status = status;
+    }
+    i2c_queue_start_next(q);
+    restore_interrupts(irq);
+
+    // O callback roda depois de liberar o barramento, podendo enfileirar a próxima etapa
+    if (txn && txn->callback) {
+        txn->callback(txn, txn->user);
+    }
+}
+
+bool i2c_queue_watchdog(i2c_queue_t *q) {
+    // Relógio lido já sem interrupções: lido antes, a IRQ poderia iniciar a próxima
+    // transação no intervalo e inicio_us > agora daria um prazo vencido falso
+    uint32_t irq = save_and_disable_interrupts();
+    uint64_t agora = time_us_64();
+    if (agora >= q->budget_refill_us) {
+        q->retry_budget = I2C_QUEUE_RETRY_BUDGET;
+        q->budget_refill_us = agora + 1000000;
+    }
+    // Uma transação parada à espera da recuperação não conta prazo, nem uma que
+    // começou depois da leitura do relógio (a subtração daria a volta)
+    bool expirou = q->atual && !q->recuperar && agora > q->inicio_us && agora - q->inicio_us > q->prazo_us;
+    if (expirou) {
+        q->abort(q);
+        q->recuperar = true;
+    }
+    bool recuperar = q->recuperar;
+    restore_interrupts(irq);
+
+    if (!recuperar) {
+        return false;
+    }
+    if (expirou) {
+        i2c_queue_complete(q, I2C_TXN_TIMEOUT);
+    }
+    i2c_queue_recover(q);
+    return true;
+}
+
+void i2c_queue_recover(i2c_queue_t *q) {
+    if (q->recover) {
+        q->recover(q);
+    }
+    q->recoveries++;
+
+    uint32_t irq = save_and_disable_interrupts();
+    q->recuperar = false;
+    if (q->atual) {
+        i2c_queue_start_atual(q);  // retentativa que aguardava o barramento
+    } else {
+        i2c_queue_start_next(q);
+    }
+    restore_interrupts(irq);
+}
+
+bool i2c_queue_transfer(i2c_queue_t *q, i2c_txn_t *txn, uint32_t timeout_us) {
+    if (!i2c_queue_submit(q, txn)) {
+        return false;
+    }
+
+    // O watchdog limita cada tentativa; timeout_us só cobre a espera na fila
+    absolute_time_t limite = make_timeout_time_us(timeout_us);
+    while (i2c_txn_pending(txn) && !time_reached(limite)) {
+        i2c_queue_watchdog(q);
+        tight_loop_contents();
+    }
+    return txn->status == I2C_TXN_OK;
+}
+
+uint8_t i2c_queue_scan(i2c_queue_t *q, uint8_t mapa[16]) {
+    i2c_txn_t txn[I2C_QUEUE_SIZE];
+    uint8_t rx[I2C_QUEUE_SIZE];
+    uint8_t encontrados = 0;
+    uint8_t addr = 0x08;
+
+    memset(mapa, 0, 16);
+    while (addr < 0x78) {
+        // Um lote por vez: todas as sondas ocupam a fila e correm sem intervalo entre si
+        uint8_t n = 0;
+        while (n < I2C_QUEUE_SIZE && addr + n < 0x78) {
+            txn[n].status = I2C_TXN_IDLE;
+            txn[n].callback = NULL;
+            txn[n].retries = 0;  // NACK é a resposta esperada dos endereços vazios
+            i2c_txn_setup(&txn[n], addr + n, NULL, 0, &rx[n], 1);
+            if (!i2c_queue_submit(q, &txn[n])) {
+                break;
+            }
+            n++;
+        }
+        if (n == 0) {
+            break;  // fila ocupada por outros clientes
+        }
+
+        for (uint8_t i = 0; i < n; i++) {
+            // Os descritores estão na pilha: só seguimos quando cada um tiver saído da
+            // fila, o que o prazo do watchdog garante
+            while (i2c_txn_pending(&txn[i])) {
+                i2c_queue_watchdog(q);
+                tight_loop_contents();
+            }
+            if (txn[i].status == I2C_TXN_OK) {
+                mapa[(addr + i) >> 3] |= 1u << ((addr + i) & 7);
+                encontrados++;
+            }
+        }
+        addr += n;
+    }
+    return encontrados;
+}
+
+bool i2c_queue_acquire(i2c_queue_t *q, uint32_t timeout_us) {
+    uint32_t irq = save_and_disable_interrupts();
+    q->reservada = true;  // nada novo começa a partir daqui
+    restore_interrupts(irq);
+
+    absolute_time_t limite = make_timeout_time_us(timeout_us);
+    while (q->atual) {
+        i2c_queue_watchdog(q);
+        if (time_reached(limite)) {
+            i2c_queue_release(q);
+            return false;
+        }
+        tight_loop_contents();
+    }
+    if (q->hold) {
+        q->hold(q, true);
+    }
+    return true;
+}
+
+void i2c_queue_release(i2c_queue_t *q) {
+    if (q->hold) {
+        q->hold(q, false);
+    }
+    uint32_t irq = save_and_disable_interrupts();
+    q->reservada = false;
+    i2c_queue_start_next(q);
+    restore_interrupts(irq);
+}
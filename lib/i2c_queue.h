@@ -0,0 +1,170 @@
+#ifndef I2C_QUEUE_H
+#define I2C_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/i2c.h"
+
+// Número máximo de transações aguardando na fila
+#define I2C_QUEUE_SIZE 8
+// Maior transação suportada (bytes escritos + bytes lidos)
+#define I2C_QUEUE_MAX_LEN 32
+// Prazo de uma transação depois de iniciada no barramento: 32 bytes a 400 kHz levam
+// ~0,8 ms, o resto é folga para clock stretching
+#define I2C_QUEUE_DEADLINE_US 3000
+// Prazo extra por palavra de um fluxo longo (um byte leva ~23 us a 400 kHz)
+#define I2C_QUEUE_STREAM_US_PER_WORD 30
+// Retentativas disponíveis por segundo em cada barramento, somando todos os dispositivos;
+// um barramento ruidoso não vira uma tempestade de retentativas
+#define I2C_QUEUE_RETRY_BUDGET 8
+// Pulsos de SCL no bus clear: o suficiente para um escravo terminar um byte e soltar o SDA
+#define I2C_QUEUE_CLEAR_PULSES 9
+
+typedef enum {
+    I2C_TXN_IDLE,
+    I2C_TXN_PENDING,
+    I2C_TXN_OK,
+    I2C_TXN_ERROR,    // perda de arbitragem ou outro abort do controlador
+    I2C_TXN_NACK,     // escravo não reconheceu o endereço ou um byte
+    I2C_TXN_TIMEOUT   // passou do prazo; o barramento foi recuperado
+} i2c_txn_status_t;
+
+// Saúde do dispositivo dono do descritor, atualizada a cada término de transação
+typedef struct {
+    uint32_t ok;
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t errors;
+    uint32_t retries;
+    uint64_t last_ok_us;   // 0 = nunca respondeu
+} i2c_health_t;
+
+typedef struct i2c_txn i2c_txn_t;
+typedef struct i2c_queue i2c_queue_t;
+
+// Chamado ao fim da transação; no backend DMA roda em contexto de interrupção
+typedef void (*i2c_txn_callback_t)(i2c_txn_t *txn, void *user);
+
+// Descritor de transação: escreve tx_len bytes e, se rx_len > 0, lê rx_len bytes
+// com repeated start. O descritor e os buffers pertencem ao driver e precisam
+// permanecer válidos até o fim da transação.
+// Com stream != NULL a transação é um fluxo de escrita pré-montado, sem limite de
+// I2C_QUEUE_MAX_LEN: cada palavra é o que vai para o IC_DATA_CMD (byte | RESTART |
+// STOP), e o dono marca o STOP na última. tx/rx são ignorados.
+struct i2c_txn {
+    uint8_t addr;
+    const uint8_t *tx;
+    uint8_t tx_len;
+    uint8_t *rx;
+    uint8_t rx_len;
+    const uint16_t *stream;
+    uint16_t stream_len;
+    i2c_txn_callback_t callback;
+    void *user;
+    volatile i2c_txn_status_t status;
+    uint8_t retries;   // retentativas permitidas em NACK/timeout/erro (0 = falha direto)
+    uint8_t attempt;   // uso interno da fila
+    i2c_health_t health;
+};
+
+struct i2c_queue {
+    i2c_txn_t *fila[I2C_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    i2c_txn_t *volatile atual;
+    volatile bool reservada;  // barramento emprestado a um cliente bloqueante
+    volatile bool recuperar;  // o backend pediu bus clear; nada começa até lá
+    uint64_t inicio_us;       // início da transação atual, para o prazo
+    uint32_t prazo_us;        // prazo da transação atual (cresce com o tamanho do fluxo)
+    uint8_t retry_budget;
+    uint64_t budget_refill_us;
+    uint32_t recoveries;
+
+    // Backend que executa a transação no barramento e chama i2c_queue_complete()
+    void (*start)(i2c_queue_t *q, i2c_txn_t *txn);
+    // Interrompe a transação atual no hardware, sem concluí-la
+    void (*abort)(i2c_queue_t *q);
+    // Suspende (true) ou retoma (false) as interrupções do backend durante a reserva
+    void (*hold)(i2c_queue_t *q, bool hold);
+    // Bus clear e reinicialização do controlador; roda fora de interrupção
+    void (*recover)(i2c_queue_t *q);
+
+    // Estado do backend DMA
+    i2c_inst_t *i2c;
+    uint sda;
+    uint scl;
+    uint baudrate;
+    int dma_tx;
+    int dma_rx;
+    uint32_t cmd[I2C_QUEUE_MAX_LEN];
+};
+
+// Inicializa a fila sobre o backend DMA do RP2040 (o i2c já deve estar configurado
+// nesses pinos e nessa frequência; a recuperação do barramento os reaplica)
+void i2c_queue_init_dma(i2c_queue_t *q, i2c_inst_t *i2c, uint sda, uint scl, uint baudrate);
+
+// Enfileira a transação e retorna imediatamente.
+// Retorna false se a fila estiver cheia, a transação for grande demais ou já estiver pendente.
+bool i2c_queue_submit(i2c_queue_t *q, i2c_txn_t *txn);
+
+// Vigia o prazo da transação em andamento: ao estourar, aborta, faz o bus clear e
+// conclui com I2C_TXN_TIMEOUT (ou tenta de novo, se houver orçamento). Também atende
+// os pedidos de recuperação do backend e recarrega o orçamento de retentativas.
+// Chamar periodicamente fora de interrupção; retorna true se recuperou o barramento.
+bool i2c_queue_watchdog(i2c_queue_t *q);
+
+// Recupera o barramento na hora (ex.: depois de um erro do cliente bloqueante sob reserva)
+void i2c_queue_recover(i2c_queue_t *q);
+
+// Enfileira e aguarda o término (para inicialização); false em erro ou timeout
+bool i2c_queue_transfer(i2c_queue_t *q, i2c_txn_t *txn, uint32_t timeout_us);
+
+// Sonda os endereços 0x08..0x77 com leituras de 1 byte, enfileiradas em lotes de
+// I2C_QUEUE_SIZE. O bit (addr % 8) de mapa[addr / 8] fica em 1 quando há ACK.
+// Bloqueante (para inicialização), cada sonda limitada por I2C_QUEUE_DEADLINE_US;
+// retorna o número de dispositivos encontrados.
+uint8_t i2c_queue_scan(i2c_queue_t *q, uint8_t mapa[16]);
+
+static inline bool i2c_queue_scan_found(const uint8_t mapa[16], uint8_t addr) {
+    return (mapa[addr >> 3] >> (addr & 7)) & 1;
+}
+
+// Empresta o barramento a um driver que usa as funções bloqueantes do SDK (ex.: o
+// display no mesmo controlador): espera a transação em andamento terminar e segura
+// as próximas na fila até i2c_queue_release(). false se o barramento não liberar a tempo.
+bool i2c_queue_acquire(i2c_queue_t *q, uint32_t timeout_us);
+void i2c_queue_release(i2c_queue_t *q);
+
+// Usado pelo backend para encerrar a transação atual e iniciar a próxima. Em falha,
+// repete a transação enquanto ela e o barramento tiverem retentativas.
+void i2c_queue_complete(i2c_queue_t *q, i2c_txn_status_t status);
+
+static inline bool i2c_txn_pending(const i2c_txn_t *txn) {
+    return txn->status == I2C_TXN_PENDING;
+}
+
+// Preenche um descritor de escrita seguida de leitura opcional.
+// callback/user não são alterados: o dono do descritor os configura uma vez.
+static inline void i2c_txn_setup(i2c_txn_t *txn, uint8_t addr, const uint8_t *tx, uint8_t tx_len,
+                                 uint8_t *rx, uint8_t rx_len) {
+    txn->addr = addr;
+    txn->tx = tx;
+    txn->tx_len = tx_len;
+    txn->rx = rx;
+    txn->rx_len = rx_len;
+    txn->stream = NULL;
+    txn->stream_len = 0;
+}
+
+// Preenche um descritor de fluxo pré-montado (ver struct i2c_txn)
+static inline void i2c_txn_setup_stream(i2c_txn_t *txn, uint8_t addr, const uint16_t *stream, uint16_t len) {
+    txn->addr = addr;
+    txn->tx = NULL;
+    txn->tx_len = 0;
+    txn->rx = NULL;
+    txn->rx_len = 0;
+    txn->stream = stream;
+    txn->stream_len = len;
+}
+
+#endif // I2C_QUEUE_H
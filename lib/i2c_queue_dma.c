@@ -0,0 +1,194 @@
+#include "i2c_queue.h"
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Uma fila por controlador I2C, para o tratador de interrupção encontrar o contexto
+static i2c_queue_t *filas_dma[2];
+
+#define I2C_QUEUE_DMA_IRQ_MASK (I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS)
+
+static void i2c_queue_dma_abort(i2c_queue_t *q) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+    uint32_t irq = save_and_disable_interrupts();
+    dma_channel_abort(q->dma_tx);
+    dma_channel_abort(q->dma_rx);
+    // Desabilitar o controlador descarta os FIFOs e libera o estado de abort
+    hw->enable = 0;
+    hw->enable = 1;
+    (void)hw->clr_intr;
+    restore_interrupts(irq);
+}
+
+static void i2c_queue_dma_irq(i2c_queue_t *q) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+    uint32_t stat = hw->intr_stat;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        uint32_t fonte = hw->tx_abrt_source;
+        i2c_txn_status_t status = I2C_TXN_ERROR;
+        if (fonte & (I2C_IC_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK_BITS | I2C_IC_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK_BITS)) {
+            status = I2C_TXN_NACK;
+        } else if (fonte & I2C_IC_TX_ABRT_SOURCE_ARB_LOST_BITS) {
+            // Alguém segura o SDA: só o bus clear resolve
+            q->recuperar = true;
+        }
+        i2c_queue_dma_abort(q);
+        if (q->atual) {
+            i2c_queue_complete(q, status);
+        }
+    } else if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (q->atual) {
+            // O último byte já está no FIFO de recepção; o DMA o consome em poucos ciclos
+            if (q->atual->rx_len && !q->atual->stream) {
+                dma_channel_wait_for_finish_blocking(q->dma_rx);
+            }
+            i2c_queue_complete(q, I2C_TXN_OK);
+        }
+    }
+}
+
+// Durante a reserva o cliente bloqueante do SDK consulta STOP_DET/TX_ABRT por
+// polling; o tratador não pode consumir esses bits
+static void i2c_queue_dma_hold(i2c_queue_t *q, bool hold) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+    if (hold) {
+        hw->intr_mask = 0;
+    } else {
+        (void)hw->clr_intr;
+        hw->intr_mask = I2C_QUEUE_DMA_IRQ_MASK;
+    }
+}
+
+// DMA nos dois sentidos; o fim da transação é sinalizado por STOP_DET ou TX_ABRT
+static void i2c_queue_dma_configurar(i2c_queue_t *q) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = q->reservada ? 0 : I2C_QUEUE_DMA_IRQ_MASK;
+}
+
+// Pinos como dreno aberto via GPIO: saída em 0 puxa a linha, entrada a solta no pull-up
+static inline void i2c_queue_linha(uint pino, bool alto) {
+    gpio_set_dir(pino, alto ? GPIO_IN : GPIO_OUT);
+    busy_wait_us(5);  // meio período a 100 kHz
+}
+
+// Bus clear (NXP UM10204, 3.1.16): pulsos de SCL até o escravo soltar o SDA, um STOP
+// para zerar a máquina de estados dele e o controlador reiniciado do zero
+static void i2c_queue_dma_recover(i2c_queue_t *q) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+    dma_channel_abort(q->dma_tx);
+    dma_channel_abort(q->dma_rx);
+    hw->enable = 0;
+
+    gpio_put(q->sda, 0);
+    gpio_put(q->scl, 0);
+    gpio_set_dir(q->sda, GPIO_IN);
+    gpio_set_dir(q->scl, GPIO_IN);
+    gpio_set_function(q->sda, GPIO_FUNC_SIO);
+    gpio_set_function(q->scl, GPIO_FUNC_SIO);
+
+    for (int i = 0; i < I2C_QUEUE_CLEAR_PULSES && !gpio_get(q->sda); i++) {
+        i2c_queue_linha(q->scl, false);
+        i2c_queue_linha(q->scl, true);
+    }
+    i2c_queue_linha(q->scl, false);
+    i2c_queue_linha(q->sda, false);
+    i2c_queue_linha(q->scl, true);
+    i2c_queue_linha(q->sda, true);
+
+    gpio_set_function(q->sda, GPIO_FUNC_I2C);
+    gpio_set_function(q->scl, GPIO_FUNC_I2C);
+    // i2c_init reseta o bloco, levando junto a configuração de DMA e interrupções
+    i2c_init(q->i2c, q->baudrate);
+    i2c_queue_dma_configurar(q);
+}
+
+static void i2c0_queue_irq_handler(void) {
+    i2c_queue_dma_irq(filas_dma[0]);
+}
+
+static void i2c1_queue_irq_handler(void) {
+    i2c_queue_dma_irq(filas_dma[1]);
+}
+
+static void i2c_queue_dma_start(i2c_queue_t *q, i2c_txn_t *txn) {
+    i2c_hw_t *hw = i2c_get_hw(q->i2c);
+
+    // O endereço do escravo só pode ser trocado com o controlador desabilitado
+    hw->enable = 0;
+    hw->tar = txn->addr;
+    hw->enable = 1;
+
+    // Fluxo pré-montado: as palavras já trazem RESTART/STOP. Escritas de 16 bits bastam
+    // (os bits de comando do IC_DATA_CMD vão até o 10) e poupam metade do buffer
+    if (txn->stream) {
+        dma_channel_config c = dma_channel_get_default_config(q->dma_tx);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, i2c_get_dreq(q->i2c, true));
+        dma_channel_configure(q->dma_tx, &c, &hw->data_cmd, txn->stream, txn->stream_len, true);
+        return;
+    }
+
+    // Cada palavra do IC_DATA_CMD carrega o byte, o bit de leitura e os bits de RESTART/STOP
+    uint n = 0;
+    for (uint i = 0; i < txn->tx_len; i++) {
+        q->cmd[n++] = txn->tx[i];
+    }
+    for (uint i = 0; i < txn->rx_len; i++) {
+        q->cmd[n++] = I2C_IC_DATA_CMD_CMD_BITS |
+                      ((i == 0 && txn->tx_len) ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    }
+    q->cmd[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    if (txn->rx_len) {
+        dma_channel_config c = dma_channel_get_default_config(q->dma_rx);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, i2c_get_dreq(q->i2c, false));
+        dma_channel_configure(q->dma_rx, &c, txn->rx, &hw->data_cmd, txn->rx_len, true);
+    }
+
+    dma_channel_config c = dma_channel_get_default_config(q->dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(q->i2c, true));
+    dma_channel_configure(q->dma_tx, &c, &hw->data_cmd, q->cmd, n, true);
+}
+
+void i2c_queue_init_dma(i2c_queue_t *q, i2c_inst_t *i2c, uint sda, uint scl, uint baudrate) {
+    q->head = 0;
+    q->count = 0;
+    q->atual = NULL;
+    q->reservada = false;
+    q->recuperar = false;
+    q->retry_budget = I2C_QUEUE_RETRY_BUDGET;
+    q->budget_refill_us = 0;
+    q->recoveries = 0;
+    q->start = i2c_queue_dma_start;
+    q->abort = i2c_queue_dma_abort;
+    q->hold = i2c_queue_dma_hold;
+    q->recover = i2c_queue_dma_recover;
+    q->i2c = i2c;
+    q->sda = sda;
+    q->scl = scl;
+    q->baudrate = baudrate;
+    q->dma_tx = dma_claim_unused_channel(true);
+    q->dma_rx = dma_claim_unused_channel(true);
+
+    uint idx = i2c_hw_index(i2c);
+    filas_dma[idx] = q;
+
+    i2c_queue_dma_configurar(q);
+
+    uint irq = idx ? I2C1_IRQ : I2C0_IRQ;
+    irq_set_exclusive_handler(irq, idx ? i2c1_queue_irq_handler : i2c0_queue_irq_handler);
+    irq_set_enabled(irq, true);
+}
@@ -0,0 +1,43 @@
+#include <string.h>
+#include "matriz.h"
+#include "hardware/dma.h"
+
+void matriz_init(MatrizLeds *m, PIO pio, uint sm) {
+    m->pio = pio;
+    m->sm = sm;
+    m->dma = dma_claim_unused_channel(true);
+    m->valido = false;
+    m->livre_us = 0;
+    m->enviados = 0;
+    m->suprimidos = 0;
+    m->adiados = 0;
+
+    dma_channel_config c = dma_channel_get_default_config(m->dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(m->dma, &c, &pio->txf[sm], m->quadro, MATRIZ_PIXELS, false);
+}
+
+bool matriz_enviar(MatrizLeds *m, const uint32_t quadro[MATRIZ_PIXELS]) {
+    if (m->valido && memcmp(quadro, m->quadro, sizeof(m->quadro)) == 0) {
+        m->suprimidos++;
+        return true;
+    }
+
+    // Começar antes do fim do latch emendaria os dois quadros nos LEDs
+    uint64_t agora = time_us_64();
+    if (dma_channel_is_busy(m->dma) || agora < m->livre_us) {
+        m->adiados++;
+        return false;
+    }
+
+    memcpy(m->quadro, quadro, sizeof(m->quadro));
+    // O último pixel sai do PIO ~MATRIZ_PIXELS * MATRIZ_PIXEL_US depois daqui; o latch vem depois
+    m->livre_us = agora + MATRIZ_PIXELS * MATRIZ_PIXEL_US + MATRIZ_LATCH_US;
+    dma_channel_transfer_from_buffer_now(m->dma, m->quadro, MATRIZ_PIXELS);
+    m->valido = true;
+    m->enviados++;
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef MATRIZ_H
+#define MATRIZ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+
+// Matriz 5x5 de WS2812 alimentada por DMA: o quadro inteiro vai para o FIFO do PIO
+// numa transferência só, e um quadro igual ao último enviado não sai do buffer.
+
+#define MATRIZ_PIXELS 25
+// Linha em 0 depois do último bit para os LEDs travarem o quadro (WS2812B: > 280 us)
+#define MATRIZ_LATCH_US 300
+// Um pixel são 24 bits a 800 kHz
+#define MATRIZ_PIXEL_US 30
+
+// Palavra do FIFO do programa ws2812 (24 bits, deslocamento à esquerda): GRB nos bits altos
+#define MATRIZ_GRB(r, g, b) ((((uint32_t)(g) << 16) | ((uint32_t)(r) << 8) | (uint32_t)(b)) << 8)
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    int dma;
+    uint32_t quadro[MATRIZ_PIXELS];  // fonte do DMA: só é reescrito com o canal parado
+    bool valido;                     // quadro[] é o que os LEDs mostram
+    uint64_t livre_us;               // fim do último quadro mais o latch
+
+    uint32_t enviados;
+    uint32_t suprimidos;   // iguais ao último: nada foi transmitido
+    uint32_t adiados;      // chegaram durante a transmissão ou o latch do anterior
+} MatrizLeds;
+
+// O programa ws2812 já deve estar carregado e rodando na state machine
+void matriz_init(MatrizLeds *m, PIO pio, uint sm);
+
+// Envia o quadro (palavras MATRIZ_GRB) sem esperar a transmissão. Retorna false se a
+// matriz ainda estava ocupada; o chamador repete na próxima atualização, que ainda
+// compara com o último quadro de fato enviado.
+bool matriz_enviar(MatrizLeds *m, const uint32_t quadro[MATRIZ_PIXELS]);
+
+#endif // MATRIZ_H
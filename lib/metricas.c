@@ -0,0 +1,87 @@
+#include "metricas.h"
+#include <stdio.h>
+
+// De 50 µs a 100 ms: cobre desde a coleta de um buffer até uma escrita completa do
+// display; numa tarefa cooperativa, acima disso tudo já é patológico (+Inf)
+const uint32_t metricas_limites_us[METRICAS_NUM_LIMITES] = {50, 250, 1000, 5000, 20000, 100000};
+
+void histograma_registrar(Histograma *h, uint32_t duracao_us) {
+    uint8_t i = 0;
+    while (i < METRICAS_NUM_LIMITES && duracao_us > metricas_limites_us[i]) {
+        i++;
+    }
+    h->baldes[i]++;
+    h->soma_us += duracao_us;
+}
+
+// snprintf devolve o tamanho pretendido; o buffer cheio não deve fazer o chamador avançar além dele
+static int metricas_limitar(int n, size_t tam) {
+    if (n < 0 || tam == 0) {
+        return 0;
+    }
+    return (size_t)n < tam ? n : (int)(tam - 1);
+}
+
+// Decimal a partir de um inteiro com 'casas' casas implícitas, sem ponto flutuante e
+// sem zeros à direita (0.000250 -> 0.00025), que só aumentariam a resposta
+static void metricas_formatar_fixo(char *buf, size_t tam, uint64_t valor, uint8_t casas) {
+    uint64_t escala = 1;
+    for (uint8_t i = 0; i < casas; i++) {
+        escala *= 10;
+    }
+    uint64_t frac = valor % escala;
+    if (frac == 0) {
+        snprintf(buf, tam, "%llu", (unsigned long long)(valor / escala));
+        return;
+    }
+    while (frac % 10 == 0) {
+        frac /= 10;
+        casas--;
+    }
+    snprintf(buf, tam, "%llu.%0*llu", (unsigned long long)(valor / escala), casas, (unsigned long long)frac);
+}
+
+int metricas_cabecalho(char *buf, size_t tam, const char *nome, const char *tipo, const char *ajuda) {
+    return metricas_limitar(snprintf(buf, tam, "# HELP %s %s\n# TYPE %s %s\n", nome, ajuda, nome, tipo), tam);
+}
+
+int metricas_histograma(char *buf, size_t tam, const char *nome, const char *rotulos, const Histograma *h) {
+    const char *sep = rotulos ? "," : "";
+    rotulos = rotulos ? rotulos : "";
+    int len = 0;
+    uint32_t acumulado = 0;
+
+    for (uint8_t i = 0; i < METRICAS_NUM_BALDES; i++) {
+        char le[16];
+        if (i < METRICAS_NUM_LIMITES) {
+            metricas_formatar_fixo(le, sizeof(le), metricas_limites_us[i], 6);
+        } else {
+            snprintf(le, sizeof(le), "+Inf");
+        }
+        acumulado += h->baldes[i];
+        len += metricas_limitar(snprintf(buf + len, tam - len, "%s_bucket{%s%sle=\"%s\"} %lu\n", nome, rotulos, sep,
+                                         le, (unsigned long)acumulado), tam - len);
+    }
+
+    // _count sai da soma dos baldes para bater com o balde +Inf mesmo durante uma escrita
+    char nome_sum[48], nome_count[48];
+    snprintf(nome_sum, sizeof(nome_sum), "%s_sum", nome);
+    snprintf(nome_count, sizeof(nome_count), "%s_count", nome);
+    len += metricas_valor_fixo(buf + len, tam - len, nome_sum, *rotulos ? rotulos : NULL, h->soma_us, 6);
+    len += metricas_valor(buf + len, tam - len, nome_count, *rotulos ? rotulos : NULL, acumulado);
+    return len;
+}
+
+int metricas_valor(char *buf, size_t tam, const char *nome, const char *rotulos, uint32_t valor) {
+    return metricas_valor_fixo(buf, tam, nome, rotulos, valor, 0);
+}
+
+int metricas_valor_fixo(char *buf, size_t tam, const char *nome, const char *rotulos, uint64_t valor,
+                        uint8_t casas) {
+    char texto[24];
+    metricas_formatar_fixo(texto, sizeof(texto), valor, casas);
+    if (rotulos) {
+        return metricas_limitar(snprintf(buf, tam, "%s{%s} %s\n", nome, rotulos, texto), tam);
+    }
+    return metricas_limitar(snprintf(buf, tam, "%s %s\n", nome, texto), tam);
+}
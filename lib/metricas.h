@@ -0,0 +1,34 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Histogramas de latência de baldes fixos e escrita no formato texto do Prometheus.
+// Não depende do SDK; o chamador mede o tempo com time_us_64().
+
+// Limites superiores dos baldes em µs; o último balde (+Inf) fica implícito
+#define METRICAS_NUM_LIMITES 6
+#define METRICAS_NUM_BALDES (METRICAS_NUM_LIMITES + 1)
+
+extern const uint32_t metricas_limites_us[METRICAS_NUM_LIMITES];
+
+// Um único escritor por histograma. Leitores em outro núcleo veem cada contador de
+// 32 bits inteiro; a soma de 64 bits pode sair um registro atrasada.
+typedef struct {
+    uint32_t baldes[METRICAS_NUM_BALDES];  // não cumulativos; acumulados na escrita
+    uint64_t soma_us;
+} Histograma;
+
+void histograma_registrar(Histograma *h, uint32_t duracao_us);
+
+// Escritores do texto de exposição. 'rotulos' é a lista sem chaves (ex.: tarefa="leds")
+// ou NULL. Cada um retorna o número de caracteres escritos, limitado a tam - 1.
+int metricas_cabecalho(char *buf, size_t tam, const char *nome, const char *tipo, const char *ajuda);
+int metricas_histograma(char *buf, size_t tam, const char *nome, const char *rotulos, const Histograma *h);
+int metricas_valor(char *buf, size_t tam, const char *nome, const char *rotulos, uint32_t valor);
+// Valor com 'casas' casas decimais implícitas (ex.: permil com 3 casas)
+int metricas_valor_fixo(char *buf, size_t tam, const char *nome, const char *rotulos, uint64_t valor,
+                        uint8_t casas);
+
+#endif // METRICAS_H
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include "ponto_fixo.h"
+
+static const int32_t potencias_10[] = { 1, 10, 100, 1000, 10000, 100000 };
+
+int fixo_formatar(char *buf, size_t tam, int32_t valor, uint8_t casas_valor, uint8_t casas_saida) {
+    if (casas_saida > casas_valor) {
+        casas_saida = casas_valor;
+    }
+
+    // Arredonda para a precisão de saída (metade se afasta do zero)
+    int32_t divisor = potencias_10[casas_valor - casas_saida];
+    bool negativo = valor < 0;
+    uint32_t magnitude = negativo ? (uint32_t)(-(int64_t)valor) : (uint32_t)valor;
+    magnitude = (magnitude + divisor / 2) / divisor;
+
+    uint32_t escala = potencias_10[casas_saida];
+    uint32_t inteira = magnitude / escala;
+    uint32_t fracao = magnitude % escala;
+    const char *sinal = (negativo && magnitude) ? "-" : "";
+
+    if (casas_saida == 0) {
+        return snprintf(buf, tam, "%s%lu", sinal, (unsigned long)inteira);
+    }
+    return snprintf(buf, tam, "%s%lu.%0*lu", sinal, (unsigned long)inteira, casas_saida, (unsigned long)fracao);
+}
+
+bool fixo_interpretar(const char *str, uint8_t casas, int32_t *out) {
+    bool negativo = false;
+    if (*str == '-' || *str == '+') {
+        negativo = (*str == '-');
+        str++;
+    }
+
+    int64_t valor = 0;
+    int casas_lidas = -1;  // -1 até encontrar o ponto decimal
+    bool digitos = false;
+    bool arredondar = false;
+
+    for (; *str; str++) {
+        if (*str == '.' && casas_lidas < 0) {
+            casas_lidas = 0;
+        } else if (*str >= '0' && *str <= '9') {
+            digitos = true;
+            if (casas_lidas >= casas) {
+                // Só o primeiro dígito excedente decide o arredondamento
+                if (casas_lidas == casas) {
+                    arredondar = (*str >= '5');
+                    casas_lidas++;
+                }
+                continue;
+            }
+            valor = valor * 10 + (*str - '0');
+            if (valor > INT32_MAX) {
+                return false;
+            }
+            if (casas_lidas >= 0) {
+                casas_lidas++;
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (!digitos) {
+        return false;
+    }
+    if (casas_lidas < 0) {
+        casas_lidas = 0;
+    }
+    for (; casas_lidas < casas; casas_lidas++) {
+        valor *= 10;
+    }
+    if (arredondar) {
+        valor++;
+    }
+    if (valor > INT32_MAX) {
+        return false;
+    }
+
+    *out = negativo ? -(int32_t)valor : (int32_t)valor;
+    return true;
+}
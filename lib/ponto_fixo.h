@@ -0,0 +1,16 @@
+#ifndef PONTO_FIXO_H
+#define PONTO_FIXO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Formata um valor inteiro com 'casas_valor' casas decimais implícitas (ex.: 2537 com 2 casas
+// = 25,37) arredondando para 'casas_saida' casas. Retorna o número de caracteres escritos.
+int fixo_formatar(char *buf, size_t tam, int32_t valor, uint8_t casas_valor, uint8_t casas_saida);
+
+// Converte texto decimal ("-1.25", "3", "0.5") para inteiro com 'casas' casas implícitas,
+// arredondando o excedente. Para no primeiro caractere que não seja dígito ou ponto.
+bool fixo_interpretar(const char *str, uint8_t casas, int32_t *out);
+
+#endif // PONTO_FIXO_H
@@ -0,0 +1,95 @@
+#include "sensores.h"
+#include "pico/stdlib.h"
+
+// --- Sensores reais ---
+
+static bool real_disparar(BackendSensores *b) {
+    BackendReal *r = (BackendReal *)b;
+    return arranjo_disparar(r->arranjo);
+}
+
+static bool real_coletar(BackendSensores *b, AmostraSensores *out) {
+    BackendReal *r = (BackendReal *)b;
+    return arranjo_coletar(r->arranjo, out);
+}
+
+static bool real_coletar_barometro(BackendSensores *b, LeituraBarometro *out) {
+    BackendReal *r = (BackendReal *)b;
+    // Chamada a cada coleta: aproveita para vigiar os prazos dos barramentos
+    arranjo_supervisionar(r->arranjo, to_ms_since_boot(get_absolute_time()));
+    return arranjo_coletar_barometro(r->arranjo, out);
+}
+
+BackendSensores *sensores_real_init(BackendReal *r, ArranjoSensores *arranjo) {
+    r->base.nome = "i2c";
+    r->base.disparar = real_disparar;
+    r->base.coletar = real_coletar;
+    r->base.coletar_barometro = real_coletar_barometro;
+    r->arranjo = arranjo;
+    return &r->base;
+}
+
+// --- Simulação ---
+
+static bool simulado_disparar(BackendSensores *b) {
+    BackendSimulado *s = (BackendSimulado *)b;
+    if (s->amostra_pronta) {
+        return false;
+    }
+
+    uint64_t agora_us = time_us_64();
+    uint32_t t_ms = (uint32_t)(agora_us / 1000) - s->inicio_ms;
+    EstadoClima clima;
+
+    // AHT20 e BMP280 são medidos de forma independente: perdem leituras em separado
+    s->amostra = (AmostraSensores){0};
+    s->amostra.inicio_us = agora_us;
+    if (simulador_medir(&s->sim, t_ms, &clima)) {
+        s->amostra.aht_ok = true;
+        s->amostra.aht.temperature = clima.temperatura;
+        s->amostra.aht.humidity = clima.umidade;
+    }
+    s->amostra_pronta = true;
+
+    if (simulador_medir(&s->sim, t_ms, &clima)) {
+        s->leitura.temperatura = clima.temperatura;
+        s->leitura.pressao = (uint32_t)clima.pressao;
+        s->leitura.pressao_min = s->leitura.pressao;
+        s->leitura.pressao_max = s->leitura.pressao;
+        s->leitura.amostras = 1;
+        s->barometro_pronto = true;
+    }
+    return true;
+}
+
+static bool simulado_coletar(BackendSensores *b, AmostraSensores *out) {
+    BackendSimulado *s = (BackendSimulado *)b;
+    if (!s->amostra_pronta) {
+        return false;
+    }
+    *out = s->amostra;
+    s->amostra_pronta = false;
+    return true;
+}
+
+static bool simulado_coletar_barometro(BackendSensores *b, LeituraBarometro *out) {
+    BackendSimulado *s = (BackendSimulado *)b;
+    if (!s->barometro_pronto) {
+        return false;
+    }
+    *out = s->leitura;
+    s->barometro_pronto = false;
+    return true;
+}
+
+BackendSensores *sensores_simulado_init(BackendSimulado *s, const PerfilClima *perfil, uint32_t semente) {
+    s->base.nome = "simulado";
+    s->base.disparar = simulado_disparar;
+    s->base.coletar = simulado_coletar;
+    s->base.coletar_barometro = simulado_coletar_barometro;
+    simulador_init(&s->sim, perfil, semente);
+    s->inicio_ms = to_ms_since_boot(get_absolute_time());
+    s->amostra_pronta = false;
+    s->barometro_pronto = false;
+    return &s->base;
+}
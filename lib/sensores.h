@@ -0,0 +1,46 @@
+#ifndef SENSORES_H
+#define SENSORES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "aquisicao.h"
+#include "barometro.h"
+#include "arranjo.h"
+#include "simulador.h"
+
+// Fonte de amostras usada pelo laço principal; o resto do firmware não sabe
+// se os dados vêm dos sensores no barramento ou de um modelo simulado
+typedef struct BackendSensores BackendSensores;
+
+struct BackendSensores {
+    const char *nome;
+    // Dispara um ciclo do AHT20 (temperatura/umidade); false se o anterior ainda corre
+    bool (*disparar)(BackendSensores *b);
+    // Entrega a amostra do ciclo disparado, uma única vez por ciclo
+    bool (*coletar)(BackendSensores *b, AmostraSensores *out);
+    // Entrega a próxima leitura decimada do barômetro, se houver. Chamada a cada
+    // coleta, mesmo sem leitura pronta: o backend real vigia os barramentos aqui
+    bool (*coletar_barometro)(BackendSensores *b, LeituraBarometro *out);
+};
+
+// Sensores reais: arranjo de AHT20/BMP280 encontrados na varredura dos barramentos
+typedef struct {
+    BackendSensores base;
+    ArranjoSensores *arranjo;
+} BackendReal;
+
+// Modelo de clima sintético; cada disparo gera uma amostra de cada canal
+typedef struct {
+    BackendSensores base;
+    Simulador sim;
+    uint32_t inicio_ms;
+    bool amostra_pronta;
+    bool barometro_pronto;
+    AmostraSensores amostra;
+    LeituraBarometro leitura;
+} BackendSimulado;
+
+BackendSensores *sensores_real_init(BackendReal *r, ArranjoSensores *arranjo);
+BackendSensores *sensores_simulado_init(BackendSimulado *s, const PerfilClima *perfil, uint32_t semente);
+
+#endif // SENSORES_H
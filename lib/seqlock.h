@@ -0,0 +1,40 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Seqlock de um escritor: o escritor nunca espera e o leitor repete a cópia se
+// ela cruzou uma escrita. Contador ímpar = escrita em andamento.
+typedef struct {
+    volatile uint32_t seq;
+} SeqLock;
+
+static inline void seqlock_escrita_inicio(SeqLock *s) {
+    s->seq++;
+    __dmb();
+}
+
+static inline void seqlock_escrita_fim(SeqLock *s) {
+    __dmb();
+    s->seq++;
+}
+
+static inline uint32_t seqlock_leitura_inicio(const SeqLock *s) {
+    uint32_t v;
+    while ((v = s->seq) & 1) {
+        tight_loop_contents();
+    }
+    __dmb();
+    return v;
+}
+
+// true se a cópia feita desde seqlock_leitura_inicio() precisa ser refeita
+static inline bool seqlock_leitura_repetir(const SeqLock *s, uint32_t v) {
+    __dmb();
+    return s->seq != v;
+}
+
+#endif // SEQLOCK_H
@@ -0,0 +1,133 @@
+#include "simulador.h"
+
+#define SEGUNDOS_DIA 86400u
+
+const PerfilClima PERFIL_ESTAVEL = {
+    .temp_media = 2400, .temp_amplitude = 0,
+    .umid_media = 5500, .umid_amplitude = 0,
+    .pressao_media = 101325, .pressao_amplitude = 0,
+    .ruido_temp = 5, .ruido_umid = 10, .ruido_pressao = 3,
+    .aceleracao = 1,
+};
+
+const PerfilClima PERFIL_DIURNO = {
+    .temp_media = 2400, .temp_amplitude = 600,
+    .umid_media = 6000, .umid_amplitude = 1500,
+    .pressao_media = 101325, .pressao_amplitude = 100,
+    .ruido_temp = 5, .ruido_umid = 10, .ruido_pressao = 3,
+    .aceleracao = 60,  // um dia a cada 24 min
+};
+
+const PerfilClima PERFIL_FRENTE_FRIA = {
+    .temp_media = 2600, .temp_amplitude = 500,
+    .umid_media = 6000, .umid_amplitude = 1200,
+    .pressao_media = 101500, .pressao_amplitude = 100,
+    .frente_periodo_s = 6 * 3600, .frente_duracao_s = 2 * 3600,
+    .frente_queda_pa = 1200, .frente_queda_temp = 800, .frente_alta_umid = 2500,
+    .ruido_temp = 5, .ruido_umid = 10, .ruido_pressao = 3,
+    .falha_permil = 5,
+    .aceleracao = 60,
+};
+
+const PerfilClima PERFIL_ESTRESSE = {
+    .temp_media = 3000, .temp_amplitude = 1200,
+    .umid_media = 5500, .umid_amplitude = 3000,
+    .pressao_media = 100000, .pressao_amplitude = 300,
+    .frente_periodo_s = 1800, .frente_duracao_s = 600,
+    .frente_queda_pa = 4000, .frente_queda_temp = 1500, .frente_alta_umid = 3000,
+    .ruido_temp = 50, .ruido_umid = 100, .ruido_pressao = 30,
+    .falha_permil = 50, .pico_permil = 20,
+    .aceleracao = 600,  // limites de alerta cruzados a cada poucos minutos
+};
+
+// xorshift32: determinístico e barato
+static uint32_t proximo_aleatorio(Simulador *s) {
+    uint32_t x = s->semente;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s->semente = x;
+    return x;
+}
+
+// Valor uniforme em [-amplitude, amplitude]
+static int32_t ruido(Simulador *s, int32_t amplitude) {
+    if (amplitude <= 0) {
+        return 0;
+    }
+    return (int32_t)(proximo_aleatorio(s) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+// Seno com fase em [0, 65536) e saída em Q15, pela aproximação de Bhaskara (erro < 0,2 %)
+static int32_t seno_q15(uint32_t fase) {
+    fase &= 0xFFFF;
+    bool negativo = fase >= 0x8000;
+    int32_t u = (int32_t)(fase & 0x7FFF);          // meia onda normalizada em Q15
+    int32_t p = (u * (32768 - u)) >> 15;           // u(1-u) em Q15, até 8192
+    int32_t s = (int32_t)(((int64_t)16 * p << 15) / (5 * 32768 - 4 * p));
+    return negativo ? -s : s;
+}
+
+// Perfil da frente: 0 fora dela, sobe linearmente até 32768 no meio e volta a 0 (Q15)
+static int32_t intensidade_frente(const PerfilClima *p, uint32_t t_s) {
+    if (p->frente_periodo_s == 0 || p->frente_duracao_s == 0) {
+        return 0;
+    }
+    uint32_t dentro = t_s % p->frente_periodo_s;
+    if (dentro >= p->frente_duracao_s) {
+        return 0;
+    }
+    uint32_t meia = p->frente_duracao_s / 2;
+    uint32_t dist = dentro < meia ? dentro : p->frente_duracao_s - dentro;
+    return (int32_t)(((uint64_t)dist << 15) / (meia ? meia : 1));
+}
+
+void simulador_init(Simulador *s, const PerfilClima *perfil, uint32_t semente) {
+    s->perfil = perfil;
+    s->semente = semente ? semente : 0x2545F491u;  // xorshift não pode partir de zero
+}
+
+void simulador_clima(const Simulador *s, uint32_t t_ms, EstadoClima *out) {
+    const PerfilClima *p = s->perfil;
+    uint32_t t_s = (uint32_t)(((uint64_t)t_ms * p->aceleracao) / 1000);
+
+    // Fase diurna deslocada para a máxima cair às 15 h (seno máximo em 1/4 do ciclo)
+    uint32_t seg_dia = (t_s + SEGUNDOS_DIA - 9 * 3600) % SEGUNDOS_DIA;
+    int32_t diurno = seno_q15((uint32_t)(((uint64_t)seg_dia << 16) / SEGUNDOS_DIA));
+    // Maré barométrica: dois ciclos por dia
+    int32_t mare = seno_q15((uint32_t)(((uint64_t)seg_dia << 17) / SEGUNDOS_DIA));
+    int32_t frente = intensidade_frente(p, t_s);
+
+    out->temperatura = p->temp_media + ((p->temp_amplitude * diurno) >> 15)
+                     - ((p->frente_queda_temp * frente) >> 15);
+    out->umidade = p->umid_media - ((p->umid_amplitude * diurno) >> 15)
+                 + ((p->frente_alta_umid * frente) >> 15);
+    out->pressao = p->pressao_media + ((p->pressao_amplitude * mare) >> 15)
+                 - ((p->frente_queda_pa * frente) >> 15);
+
+    if (out->umidade < 0) out->umidade = 0;
+    if (out->umidade > 10000) out->umidade = 10000;
+}
+
+bool simulador_medir(Simulador *s, uint32_t t_ms, EstadoClima *out) {
+    const PerfilClima *p = s->perfil;
+
+    if (proximo_aleatorio(s) % 1000 < p->falha_permil) {
+        return false;
+    }
+
+    simulador_clima(s, t_ms, out);
+    out->temperatura += ruido(s, p->ruido_temp);
+    out->umidade += ruido(s, p->ruido_umid);
+    out->pressao += ruido(s, p->ruido_pressao);
+
+    // Glitch de barramento: um canal sai com valor absurdo
+    if (proximo_aleatorio(s) % 1000 < p->pico_permil) {
+        switch (proximo_aleatorio(s) % 3) {
+            case 0: out->temperatura += 5000; break;
+            case 1: out->umidade = 0; break;
+            default: out->pressao -= 20000; break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef SIMULADOR_H
+#define SIMULADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Perfil de clima sintético; grandezas nas unidades internas (0.01 °C, 0.01 %, Pa)
+typedef struct {
+    int32_t temp_media;
+    int32_t temp_amplitude;      // ciclo diurno: máxima às 15 h, mínima às 3 h
+    int32_t umid_media;
+    int32_t umid_amplitude;      // em oposição de fase à temperatura
+    int32_t pressao_media;
+    int32_t pressao_amplitude;   // maré barométrica semidiurna
+    uint32_t frente_periodo_s;   // intervalo entre frentes (0 = sem frentes)
+    uint32_t frente_duracao_s;
+    int32_t frente_queda_pa;     // queda de pressão no auge da frente
+    int32_t frente_queda_temp;
+    int32_t frente_alta_umid;
+    int32_t ruido_temp;          // ruído uniforme de pico
+    int32_t ruido_umid;
+    int32_t ruido_pressao;
+    uint16_t falha_permil;       // leituras perdidas (sensor não responde), por mil
+    uint16_t pico_permil;        // leituras espúrias (glitch de barramento), por mil
+    uint16_t aceleracao;         // segundos simulados por segundo real
+} PerfilClima;
+
+// Perfis prontos
+extern const PerfilClima PERFIL_ESTAVEL;
+extern const PerfilClima PERFIL_DIURNO;
+extern const PerfilClima PERFIL_FRENTE_FRIA;
+extern const PerfilClima PERFIL_ESTRESSE;
+
+typedef struct {
+    int32_t temperatura;  // 0.01 °C
+    int32_t umidade;      // 0.01 %
+    int32_t pressao;      // Pa
+} EstadoClima;
+
+typedef struct {
+    const PerfilClima *perfil;
+    uint32_t semente;
+} Simulador;
+
+// Mesma semente e mesmos instantes produzem sempre a mesma sequência
+void simulador_init(Simulador *s, const PerfilClima *perfil, uint32_t semente);
+
+// Valor do modelo físico, sem ruído, no instante t_ms (tempo real desde o início)
+void simulador_clima(const Simulador *s, uint32_t t_ms, EstadoClima *out);
+
+// Leitura simulada com ruído e picos; retorna false quando a leitura é perdida
+bool simulador_medir(Simulador *s, uint32_t t_ms, EstadoClima *out);
+
+#endif // SIMULADOR_H
@@ -1,3 +1,4 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
 
@@ -11,110 +12,425 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow = calloc(ssd->bufsize - 1, sizeof(uint8_t));
+  ssd->tx_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->bytes_sent = 0;
+  ssd->queue = NULL;
+  ssd->busy = false;
+  ssd->tx_failed = false;
+  ssd->frames_dropped = 0;
+  ssd->tx_failures = 0;
+  ssd1306_invalidate(ssd);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
-}
-
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  const uint8_t commands[] = {
+    SET_DISP | 0x00,
+    SET_MEM_ADDR, 0x01,
+    SET_DISP_START_LINE | 0x00,
+    SET_SEG_REMAP | 0x01,
+    SET_MUX_RATIO, ssd->height - 1,
+    SET_COM_OUT_DIR | 0x08,
+    SET_DISP_OFFSET, 0x00,
+    SET_COM_PIN_CFG, 0x12,
+    SET_DISP_CLK_DIV, 0x80,
+    SET_PRECHARGE, 0xF1,
+    SET_VCOM_DESEL, 0x30,
+    SET_CONTRAST, 0xFF,
+    SET_ENTIRE_ON,
+    SET_NORM_INV,
+    SET_CHARGE_PUMP, 0x14,
+    SET_DISP | 0x01,
+  };
+  ssd1306_commands(ssd, commands, sizeof(commands));
+  // A memória do painel tem conteúdo indefinido depois da configuração
+  ssd1306_invalidate(ssd);
 }
 
-void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
+// Escrita com prazo proporcional ao tamanho: um display travado não prende o laço
+static bool ssd1306_write(ssd1306_t *ssd, const uint8_t *buf, size_t len) {
+  int ret = i2c_write_timeout_us(
     ssd->i2c_port,
     ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
+    buf,
+    len,
+    false,
+    SSD1306_TIMEOUT_BASE_US + len * SSD1306_TIMEOUT_BYTE_US
   );
+  return ret == (int)len;
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
+bool ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd->port_buffer[1] = command;
+  return ssd1306_write(ssd, ssd->port_buffer, 2);
+}
+
+bool ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buf[1 + SSD1306_MAX_COMMANDS];
+  if (len > SSD1306_MAX_COMMANDS)
+    return false;
+  buf[0] = 0x00;
+  memcpy(buf + 1, commands, len);
+  return ssd1306_write(ssd, buf, len + 1);
+}
+
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->shadow_valid = false;
+  ssd->dirty = true;
+  ssd->dirty_x0 = 0;
+  ssd->dirty_x1 = ssd->width - 1;
+  ssd->dirty_p0 = 0;
+  ssd->dirty_p1 = ssd->pages - 1;
+}
+
+// Chamada pelas primitivas de desenho; as coordenadas já chegam recortadas
+static void ssd1306_mark(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  if (!ssd->dirty) {
+    ssd->dirty = true;
+    ssd->dirty_x0 = x0;
+    ssd->dirty_x1 = x1;
+    ssd->dirty_p0 = p0;
+    ssd->dirty_p1 = p1;
+    return;
+  }
+  if (x0 < ssd->dirty_x0) ssd->dirty_x0 = x0;
+  if (x1 > ssd->dirty_x1) ssd->dirty_x1 = x1;
+  if (p0 < ssd->dirty_p0) ssd->dirty_p0 = p0;
+  if (p1 > ssd->dirty_p1) ssd->dirty_p1 = p1;
+}
+
+// Uma janela: endereços e dados em duas transações. No endereçamento vertical o
+// painel percorre as páginas p0..p1 de cada coluna antes de passar à seguinte,
+// a mesma ordem do buffer
+static bool ssd1306_send_window(ssd1306_t *ssd, const ssd1306_window_t *w) {
+  const uint8_t commands[] = {SET_COL_ADDR, w->x0, w->x1, SET_PAGE_ADDR, w->p0, w->p1};
+  if (!ssd1306_commands(ssd, commands, sizeof(commands)))
+    return false;
+
+  uint8_t altura = w->p1 - w->p0 + 1;
+  size_t n = 0;
+  ssd->tx_buffer[n++] = 0x40;
+  for (uint8_t x = w->x0; x <= w->x1; ++x) {
+    memcpy(ssd->tx_buffer + n, ssd->ram_buffer + 1 + (uint16_t)x * ssd->pages + w->p0, altura);
+    n += altura;
+  }
+  if (!ssd1306_write(ssd, ssd->tx_buffer, n))
+    return false;
+
+  // Só o que chegou ao painel entra no shadow: uma janela perdida volta no próximo envio
+  for (uint8_t x = w->x0; x <= w->x1; ++x) {
+    uint16_t i = (uint16_t)x * ssd->pages + w->p0;
+    memcpy(ssd->shadow + i, ssd->ram_buffer + 1 + i, altura);
+  }
+  ssd->bytes_sent += n - 1;
+  return true;
+}
+
+// Refina o retângulo marcado em colunas que mudaram de fato, página a página (um
+// quadro redesenhado do zero costuma diferir do anterior em poucos dígitos), e junta
+// páginas vizinhas numa janela quando os bytes extras custam menos que o cabeçalho
+// de uma janela nova. Retorna o número de janelas
+static uint8_t ssd1306_plan(ssd1306_t *ssd, ssd1306_window_t janelas[SSD1306_MAX_PAGES]) {
+  int16_t ini[SSD1306_MAX_PAGES], fim[SSD1306_MAX_PAGES];
+  for (uint8_t p = 0; p < ssd->pages; ++p) {
+    ini[p] = -1;
+    fim[p] = -1;
+    if (p < ssd->dirty_p0 || p > ssd->dirty_p1)
+      continue;
+    for (uint8_t x = ssd->dirty_x0; x <= ssd->dirty_x1; ++x) {
+      uint16_t i = (uint16_t)x * ssd->pages + p;
+      if (!ssd->shadow_valid || ssd->ram_buffer[1 + i] != ssd->shadow[i]) {
+        if (ini[p] < 0)
+          ini[p] = x;
+        fim[p] = x;
+      }
+    }
+  }
+
+  uint8_t n = 0;
+  int16_t p0 = -1, x0 = 0, x1 = 0;
+  for (uint8_t p = 0; p <= ssd->pages; ++p) {
+    bool suja = p < ssd->pages && ini[p] >= 0;
+    if (suja && p0 >= 0) {
+      int16_t a = ini[p] < x0 ? ini[p] : x0;
+      int16_t b = fim[p] > x1 ? fim[p] : x1;
+      int32_t junto = (int32_t)(p - p0 + 1) * (b - a + 1);
+      int32_t separado = (int32_t)(p - p0) * (x1 - x0 + 1) + (fim[p] - ini[p] + 1) + SSD1306_WINDOW_OVERHEAD;
+      if (junto <= separado) {
+        x0 = a;
+        x1 = b;
+        continue;
+      }
+    }
+    if (p0 >= 0) {
+      janelas[n++] = (ssd1306_window_t){(uint8_t)x0, (uint8_t)x1, (uint8_t)p0, (uint8_t)(p - 1)};
+      p0 = -1;
+    }
+    if (suja) {
+      p0 = p;
+      x0 = ini[p];
+      x1 = fim[p];
+    }
+  }
+  return n;
+}
+
+bool ssd1306_send_data(ssd1306_t *ssd) {
+  if (ssd->queue)
+    return ssd1306_swap(ssd);
+  if (!ssd->dirty)
+    return true;
+
+  ssd1306_window_t janelas[SSD1306_MAX_PAGES];
+  uint8_t n = ssd1306_plan(ssd, janelas);
+  bool ok = true;
+  for (uint8_t i = 0; i < n && ok; ++i)
+    ok = ssd1306_send_window(ssd, &janelas[i]);
+
+  // Uma escrita que falha no meio deixa parte da janela no painel sem passar pelo
+  // shadow: se o quadro voltar ao conteúdo antigo, a comparação não veria a diferença.
+  // Como na troca pela fila, a falha invalida o shadow e o próximo envio é completo
+  if (ok) {
+    ssd->dirty = false;
+    ssd->shadow_valid = true;
+  } else {
+    ssd1306_invalidate(ssd);
+  }
+  return ok;
+}
+
+// --- Envio em segundo plano ---
+// O ram_buffer é o buffer de trás, onde se desenha; o da frente é o fluxo de palavras
+// do IC_DATA_CMD montado na troca, que o DMA da fila consome enquanto o próximo quadro
+// é desenhado. Todas as janelas vão numa transação só, separadas por repeated start:
+// [0x00, endereços] Sr [0x40, dados] Sr [0x00, ...] ... P
+
+static void ssd1306_queue_done(i2c_txn_t *txn, void *user) {
+  ssd1306_t *ssd = user;
+  // Contexto de interrupção: só sinaliza; a troca seguinte trata a falha
+  if (txn->status != I2C_TXN_OK)
+    ssd->tx_failed = true;
+  ssd->busy = false;
+}
+
+void ssd1306_attach_queue(ssd1306_t *ssd, i2c_queue_t *queue) {
+  ssd->front_cap = (ssd->bufsize - 1) + ssd->pages * 8;
+  ssd->front = calloc(ssd->front_cap, sizeof(uint16_t));
+  ssd->txn.callback = ssd1306_queue_done;
+  ssd->txn.user = ssd;
+  ssd->txn.retries = 0;
+  ssd->busy = false;
+  ssd->tx_failed = false;
+  ssd->queue = queue;
+}
+
+bool ssd1306_busy(ssd1306_t *ssd) {
+  return ssd->busy;
+}
+
+bool ssd1306_swap(ssd1306_t *ssd) {
+  if (ssd->busy) {
+    // O quadro em trânsito segue; as marcas deste ficam para a próxima troca
+    ssd->frames_dropped++;
+    return false;
+  }
+  if (ssd->tx_failed) {
+    // Não se sabe quanto do quadro anterior chegou ao painel
+    ssd->tx_failed = false;
+    ssd->tx_failures++;
+    ssd1306_invalidate(ssd);
+  }
+  if (!ssd->dirty)
+    return true;
+
+  ssd1306_window_t janelas[SSD1306_MAX_PAGES];
+  uint8_t n = ssd1306_plan(ssd, janelas);
+  uint16_t *w = ssd->front;
+  uint32_t dados = 0;
+  for (uint8_t k = 0; k < n; ++k) {
+    const ssd1306_window_t *j = &janelas[k];
+    *w++ = 0x00 | (k ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    *w++ = SET_COL_ADDR;
+    *w++ = j->x0;
+    *w++ = j->x1;
+    *w++ = SET_PAGE_ADDR;
+    *w++ = j->p0;
+    *w++ = j->p1;
+    *w++ = 0x40 | I2C_IC_DATA_CMD_RESTART_BITS;
+    uint8_t altura = j->p1 - j->p0 + 1;
+    for (uint8_t x = j->x0; x <= j->x1; ++x) {
+      uint16_t i = (uint16_t)x * ssd->pages + j->p0;
+      for (uint8_t b = 0; b < altura; ++b)
+        *w++ = ssd->ram_buffer[1 + i + b];
+      // O shadow passa a descrever o quadro em trânsito; uma falha o invalida
+      memcpy(ssd->shadow + i, ssd->ram_buffer + 1 + i, altura);
+    }
+    dados += (uint32_t)altura * (j->x1 - j->x0 + 1);
+  }
+  ssd->dirty = false;
+  if (n == 0) {
+    ssd->shadow_valid = true;
+    return true;
+  }
+  w[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  i2c_txn_setup_stream(&ssd->txn, ssd->address, ssd->front, (uint16_t)(w - ssd->front));
+  ssd->busy = true;
+  if (!i2c_queue_submit(ssd->queue, &ssd->txn)) {
+    ssd->busy = false;
+    ssd->frames_dropped++;
+    ssd1306_invalidate(ssd);
+    return false;
+  }
+  ssd->shadow_valid = true;
+  ssd->bytes_sent += dados;
+  return true;
+}
+
+// --- Raster por página ---
+// Com SET_MEM_ADDR = 0x01 (endereçamento vertical) o buffer é uma coluna após a outra:
+// o byte da página p na coluna x fica em ram_buffer[1 + x * pages + p] e o bit n
+// dele é a linha 8 * p + n. Uma coluna inteira é contígua; uma linha tem passo 'pages'.
+
+static inline uint8_t *ssd1306_byte(ssd1306_t *ssd, uint8_t x, uint8_t page) {
+  return &ssd->ram_buffer[1 + (uint16_t)x * ssd->pages + page];
+}
+
+static inline void ssd1306_apply(uint8_t *byte, uint8_t mask, bool value) {
   if (value)
-    ssd->ram_buffer[index] |= (1 << pixel);
+    *byte |= mask;
   else
-    ssd->ram_buffer[index] &= ~(1 << pixel);
+    *byte &= ~mask;
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Bits de 'de' até 'ate' (inclusive) dentro de um byte de página
+static inline uint8_t ssd1306_bits(uint8_t de, uint8_t ate) {
+  return (uint8_t)((0xFF << de) & (0xFF >> (7 - ate)));
+}
+
+// Recorta o retângulo ao display; false se nada sobrar
+static bool ssd1306_clip(const ssd1306_t *ssd, int *x, int *y, int *w, int *h) {
+  if (*x < 0) { *w += *x; *x = 0; }
+  if (*y < 0) { *h += *y; *y = 0; }
+  if (*x + *w > ssd->width) *w = ssd->width - *x;
+  if (*y + *h > ssd->height) *h = ssd->height - *y;
+  return *w > 0 && *h > 0;
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  ssd1306_apply(ssd1306_byte(ssd, x, y >> 3), 1u << (y & 7), value);
+  ssd1306_mark(ssd, x, x, y >> 3, y >> 3);
+}
 
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
+
+void ssd1306_page_span(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1, uint8_t mask, bool value) {
+  if (page >= ssd->pages || x0 >= ssd->width)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  uint8_t *byte = ssd1306_byte(ssd, x0, page);
+  for (uint8_t x = x0; x <= x1; ++x, byte += ssd->pages)
+    ssd1306_apply(byte, mask, value);
+  ssd1306_mark(ssd, x0, x1, page, page);
+}
+
+void ssd1306_fill_rect(ssd1306_t *ssd, int x, int y, int w, int h, bool value) {
+  if (!ssd1306_clip(ssd, &x, &y, &w, &h))
+    return;
+
+  // Máscaras da primeira e da última página; as do meio são bytes inteiros
+  uint8_t y1 = y + h - 1;
+  uint8_t p0 = y >> 3, p1 = y1 >> 3;
+  uint8_t m0 = ssd1306_bits(y & 7, p0 == p1 ? (y1 & 7) : 7);
+  uint8_t m1 = ssd1306_bits(0, y1 & 7);
+  uint8_t cheio = value ? 0xFF : 0x00;
+  ssd1306_mark(ssd, x, x + w - 1, p0, p1);
+
+  for (int col = x; col < x + w; ++col) {
+    uint8_t *byte = ssd1306_byte(ssd, col, p0);
+    ssd1306_apply(byte, m0, value);
+    if (p1 > p0) {
+      // Coluna contígua no buffer: páginas inteiras num memset só
+      memset(byte + 1, cheio, p1 - p0 - 1);
+      ssd1306_apply(byte + (p1 - p0), m1, value);
     }
+  }
 }
 
+void ssd1306_clear_region(ssd1306_t *ssd, int x, int y, int w, int h) {
+  ssd1306_fill_rect(ssd, x, y, w, h, false);
+}
 
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1, uint8_t n) {
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+  if (p1 >= ssd->pages) p1 = ssd->pages - 1;
+  if (x0 > x1 || p0 > p1 || n == 0)
+    return;
+  if (n > x1 - x0) {
+    // Tudo sai da região: nada a mover, o chamador redesenha
+    ssd1306_mark(ssd, x0, x1, p0, p1);
+    return;
+  }
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  // Colunas são contíguas no buffer: com todas as páginas o deslocamento é um memmove só
+  uint8_t altura = p1 - p0 + 1;
+  uint8_t colunas = x1 - x0 + 1 - n;
+  if (altura == ssd->pages) {
+    memmove(ssd1306_byte(ssd, x0, 0), ssd1306_byte(ssd, x0 + n, 0), (size_t)colunas * ssd->pages);
+  } else {
+    for (uint8_t x = x0; x < x0 + colunas; ++x)
+      memcpy(ssd1306_byte(ssd, x, p0), ssd1306_byte(ssd, x + n, p0), altura);
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+  ssd1306_mark(ssd, x0, x1, p0, p1);
+}
+
+void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
+  if (x0 > x1) {
+    uint8_t t = x0; x0 = x1; x1 = t;
   }
+  if (y >= ssd->height)
+    return;
+  ssd1306_page_span(ssd, y >> 3, x0, x1, 1u << (y & 7), value);
+}
 
+void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  if (y0 > y1) {
+    uint8_t t = y0; y0 = y1; y1 = t;
+  }
+  ssd1306_fill_rect(ssd, x, y0, 1, y1 - y0 + 1, value);
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0)
+    return;
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_rect(ssd, left, top, width, height, value);
+    return;
   }
+  uint8_t right = left + width - 1, bottom = top + height - 1;
+  ssd1306_hline(ssd, left, right, top, value);
+  ssd1306_hline(ssd, left, right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom, value);
+  ssd1306_vline(ssd, right, top, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Retas alinhadas aos eixos (as mais comuns nas telas) viram spans
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0, x1, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0, y1, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -142,18 +458,10 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
     }
 }
 
-
-void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
-}
-
-void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
-}
-
 // Função para desenhar um caractere
+// A fonte guarda cada glyph como 8 colunas de 8 bits (bit j = linha j), o mesmo formato
+// de um byte de página: com y múltiplo de 8 a coluna é copiada direto; fora disso ela
+// é deslocada e dividida entre duas páginas. O glyph é opaco (apaga o fundo da célula)
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
   uint16_t index = 0;
@@ -163,21 +471,42 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
   {
     index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
   }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
+  // Caractere inválido: índice 0, que corresponde ao espaço
+
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint8_t colunas = ssd->width - x < 8 ? ssd->width - x : 8;
+  uint8_t page = y >> 3, shift = y & 7;
+  const uint8_t *glyph = &font[index];
+  uint8_t *byte = ssd1306_byte(ssd, x, page);
+
+  if (shift == 0) {
+    for (uint8_t i = 0; i < colunas; ++i, byte += ssd->pages)
+      *byte = glyph[i];
+    ssd1306_mark(ssd, x, x + colunas - 1, page, page);
+    return;
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+  // Parte de cima nos bits altos da página 'page', resto nos bits baixos da seguinte
+  bool segunda = page + 1 < ssd->pages;
+  uint8_t m0 = 0xFF << shift, m1 = 0xFF >> (8 - shift);
+  for (uint8_t i = 0; i < colunas; ++i, byte += ssd->pages) {
+    byte[0] = (byte[0] & ~m0) | (uint8_t)(glyph[i] << shift);
+    if (segunda)
+      byte[1] = (byte[1] & ~m1) | (glyph[i] >> (8 - shift));
   }
+  ssd1306_mark(ssd, x, x + colunas - 1, page, segunda ? page + 1 : page);
+}
+
+// Modelos de tela: cópia do quadro inteiro (bufsize - 1 bytes) para/de um buffer do chamador.
+// Carregar um modelo marca tudo como alterado; o shadow filtra o que de fato mudou
+void ssd1306_save_frame(ssd1306_t *ssd, uint8_t *frame) {
+  memcpy(frame, ssd->ram_buffer + 1, ssd->bufsize - 1);
+}
+
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame) {
+  memcpy(ssd->ram_buffer + 1, frame, ssd->bufsize - 1);
+  ssd1306_mark(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
 }
 
 // Função para desenhar uma string
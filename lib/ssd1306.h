@@ -1,10 +1,23 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "i2c_queue.h"
 
 #define WIDTH 128
 #define HEIGHT 64
 
+// Maior display suportado (128x64): limita as tabelas por página
+#define SSD1306_MAX_PAGES 8
+// Maior sequência de comandos enviada numa transação
+#define SSD1306_MAX_COMMANDS 32
+// Custo fixo de uma janela extra (comandos de endereço + início/endereço da escrita),
+// em bytes no barramento: abaixo disso vale mais estender a janela anterior
+#define SSD1306_WINDOW_OVERHEAD 12
+
+// Prazo de cada escrita: base + por byte (um byte leva ~23 us a 400 kHz)
+#define SSD1306_TIMEOUT_BASE_US 1000
+#define SSD1306_TIMEOUT_BYTE_US 50
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -32,18 +45,69 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+
+  // Atualização parcial: retângulo marcado pelas primitivas desde o último envio e cópia
+  // do que o painel já mostra (shadow), comparada para achar as colunas que mudaram
+  bool dirty;
+  uint8_t dirty_x0, dirty_x1, dirty_p0, dirty_p1;
+  uint8_t *shadow;
+  bool shadow_valid;
+  uint8_t *tx_buffer;     // janela montada para envio (byte de controle + dados)
+  uint32_t bytes_sent;    // dados de imagem enviados desde o init
+
+  // Envio em segundo plano pela fila do barramento (NULL = envio bloqueante)
+  i2c_queue_t *queue;
+  i2c_txn_t txn;
+  uint16_t *front;        // quadro em trânsito, já como palavras do IC_DATA_CMD
+  size_t front_cap;
+  volatile bool busy;
+  volatile bool tx_failed;
+  uint32_t frames_dropped;  // trocas recusadas com um quadro ainda em trânsito
+  uint32_t tx_failures;     // quadros que não chegaram ao painel
 } ssd1306_t;
 
+// Retângulo de colunas x0..x1 e páginas p0..p1 enviado numa escrita
+typedef struct {
+  uint8_t x0, x1, p0, p1;
+} ssd1306_window_t;
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
-void ssd1306_command(ssd1306_t *ssd, uint8_t command);
-void ssd1306_send_data(ssd1306_t *ssd);
+bool ssd1306_command(ssd1306_t *ssd, uint8_t command);
+// Vários comandos numa transação só (byte de controle 0x00 seguido do fluxo)
+bool ssd1306_commands(ssd1306_t *ssd, const uint8_t *commands, size_t len);
+// Envia só as janelas que mudaram desde o último envio bem-sucedido; sem mudanças,
+// não toca o barramento. Depois de uma falha o envio seguinte é o quadro inteiro
+bool ssd1306_send_data(ssd1306_t *ssd);
+// Força o próximo envio a mandar o quadro inteiro (ex.: painel reiniciado)
+void ssd1306_invalidate(ssd1306_t *ssd);
+
+// Passa os envios para a fila com DMA do barramento: ssd1306_send_data vira
+// ssd1306_swap. A fila precisa estar no mesmo controlador de i2c_port
+void ssd1306_attach_queue(ssd1306_t *ssd, i2c_queue_t *queue);
+// Monta as janelas alteradas no buffer da frente e as entrega à fila sem esperar.
+// Com um quadro ainda em trânsito, descarta a troca (frames_dropped) e retorna false;
+// as alterações continuam marcadas e vão na troca seguinte
+bool ssd1306_swap(ssd1306_t *ssd);
+bool ssd1306_busy(ssd1306_t *ssd);
 
+// Primitivas de raster: trabalham em bytes de página inteiros e recortam ao display.
+// Coordenadas fora da tela são ignoradas; retângulos parcialmente fora são recortados.
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+// Aplica 'mask' (bit n = linha 8 * page + n) nas colunas x0..x1 de uma página
+void ssd1306_page_span(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1, uint8_t mask, bool value);
+void ssd1306_fill_rect(ssd1306_t *ssd, int x, int y, int w, int h, bool value);
+void ssd1306_clear_region(ssd1306_t *ssd, int x, int y, int w, int h);
+// Desloca as colunas x0..x1 das páginas p0..p1 'n' colunas para a esquerda; as 'n'
+// últimas ficam com o conteúdo antigo, para o chamador desenhar as novas por cima
+void ssd1306_scroll_left(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1, uint8_t n);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+// Quadro inteiro sem o byte de controle: width * height / 8 bytes
+void ssd1306_save_frame(ssd1306_t *ssd, uint8_t *frame);
+void ssd1306_load_frame(ssd1306_t *ssd, const uint8_t *frame);
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include "telas.h"
+#include "ponto_fixo.h"
+
+void telas_init(Telas *t, ssd1306_t *ssd) {
+    t->ssd = ssd;
+    t->desenhada = NUM_TELAS;
+
+    ssd1306_fill(ssd, false);
+    ssd1306_rect(ssd, 2, 2, 124, 60, true, false);
+    ssd1306_line(ssd, 2, 15, 126, 15, true);
+    ssd1306_draw_string(ssd, "Temp: ", 4, 20);
+    ssd1306_draw_string(ssd, "Umid: ", 4, 30);
+    ssd1306_draw_string(ssd, "Pres: ", 4, 40);
+    ssd1306_draw_string(ssd, "Alt: ", 4, 50);
+    ssd1306_save_frame(ssd, t->modelo[TELA_SENSORES]);
+
+    ssd1306_fill(ssd, false);
+    ssd1306_rect(ssd, 2, 2, 124, 60, true, false);
+    ssd1306_draw_string(ssd, "STATUS CONEXAO", 10, 5);
+    ssd1306_line(ssd, 2, 15, 126, 15, true);
+    ssd1306_save_frame(ssd, t->modelo[TELA_WIFI]);
+}
+
+// Coluna do i-ésimo ponto (alinhado à direita): segmento vertical desde o ponto anterior
+static void desenhar_coluna_grafico(ssd1306_t *ssd, const Tendencia *t, uint8_t i) {
+    uint8_t x = WIDTH - t->n + i;
+    uint8_t y = tendencia_linha(t, tendencia_ponto(t, i), GRAFICO_ALTURA);
+    uint8_t y_ant = i ? tendencia_linha(t, tendencia_ponto(t, i - 1), GRAFICO_ALTURA) : y;
+    ssd1306_fill_rect(ssd, x, GRAFICO_Y, 1, GRAFICO_ALTURA, false);
+    ssd1306_vline(ssd, x, GRAFICO_Y + (y < y_ant ? y : y_ant), GRAFICO_Y + (y < y_ant ? y_ant : y), true);
+}
+
+// Um ponto novo desloca a área do gráfico e desenha só a coluna nova; a série inteira
+// só é redesenhada ao entrar na tela ou quando a escala muda
+static void desenhar_grafico(Telas *telas, TipoTela tela, Tendencia *t, const char *rotulo, const char *valor) {
+    ssd1306_t *ssd = telas->ssd;
+    bool completo = telas->desenhada != tela || t->reescalar || t->novos >= t->n;
+    if (completo) {
+        ssd1306_fill(ssd, false);
+        for (uint8_t i = 0; i < t->n; i++) {
+            desenhar_coluna_grafico(ssd, t, i);
+        }
+    } else if (t->novos) {
+        ssd1306_scroll_left(ssd, 0, WIDTH - 1, GRAFICO_PAGINA, ssd->pages - 1, t->novos);
+        for (uint8_t i = t->n - t->novos; i < t->n; i++) {
+            desenhar_coluna_grafico(ssd, t, i);
+        }
+        // Com o anel cheio o ponto mais antigo saiu: a primeira coluna perde o segmento
+        if (t->n == TENDENCIA_PONTOS) {
+            desenhar_coluna_grafico(ssd, t, 0);
+        }
+    }
+    t->novos = 0;
+    t->reescalar = false;
+
+    char linha[20];
+    snprintf(linha, sizeof(linha), "%s 1h %s", rotulo, valor);
+    ssd1306_clear_region(ssd, 0, 0, WIDTH, GRAFICO_Y);
+    ssd1306_draw_string(ssd, linha, 0, 0);
+}
+
+static void desenhar_sensores(ssd1306_t *ssd, const DadosTela *d) {
+    char num[12];
+    char str_temp[16], str_umid[16], str_press[16], str_alt[16];
+    char header[20];
+
+    fixo_formatar(num, sizeof(num), d->temperatura, 2, 1);
+    snprintf(str_temp, sizeof(str_temp), "%sC", num);
+    fixo_formatar(num, sizeof(num), d->umidade, 2, 1);
+    snprintf(str_umid, sizeof(str_umid), "%s%%", num);
+    fixo_formatar(num, sizeof(num), d->pressao, 3, 1);
+    snprintf(str_press, sizeof(str_press), "%skPa", num);
+    fixo_formatar(num, sizeof(num), d->altitude, 1, 0);
+    snprintf(str_alt, sizeof(str_alt), "%sm", num);
+    snprintf(header, sizeof(header), "-> %s", d->status);
+    // Valor que parou de ser atualizado não é mostrado como se fosse atual
+    if (d->temp_umid_obsoletas) {
+        snprintf(str_temp, sizeof(str_temp), "--");
+        snprintf(str_umid, sizeof(str_umid), "--");
+    }
+    if (d->pressao_obsoleta) {
+        snprintf(str_press, sizeof(str_press), "--");
+        snprintf(str_alt, sizeof(str_alt), "--");
+    }
+
+    ssd1306_draw_string(ssd, header, 4, 5);
+    ssd1306_draw_string(ssd, str_temp, 45, 20);
+    ssd1306_draw_string(ssd, str_umid, 45, 30);
+    ssd1306_draw_string(ssd, str_press, 45, 40);
+    ssd1306_draw_string(ssd, str_alt, 35, 50);
+}
+
+static void desenhar_wifi(ssd1306_t *ssd, const DadosTela *d) {
+    if (d->wifi_conectado) {
+        ssd1306_draw_string(ssd, "WiFi: CONECTADO", 4, 20);
+        ssd1306_draw_string(ssd, "IP:", 4, 30);
+        ssd1306_draw_string(ssd, d->ip, 4, 40);
+        ssd1306_draw_string(ssd, "Porta: 80", 4, 50);
+    } else {
+        ssd1306_draw_string(ssd, "WiFi: DESCONEC.", 4, 25);
+        ssd1306_draw_string(ssd, "Verifique rede", 4, 40);
+    }
+}
+
+void telas_desenhar(Telas *t, TipoTela tela, const DadosTela *d) {
+    char num[12], valor[16];
+    switch (tela) {
+        case TELA_GRAFICO_TEMPERATURA:
+            fixo_formatar(num, sizeof(num), d->temperatura, 2, 1);
+            snprintf(valor, sizeof(valor), "%sC", d->temp_umid_obsoletas ? "--" : num);
+            desenhar_grafico(t, tela, d->tendencia_temperatura, "T", valor);
+            break;
+        case TELA_GRAFICO_PRESSAO:
+            fixo_formatar(num, sizeof(num), d->pressao, 3, 1);
+            snprintf(valor, sizeof(valor), "%skPa", d->pressao_obsoleta ? "--" : num);
+            desenhar_grafico(t, tela, d->tendencia_pressao, "P", valor);
+            break;
+        case TELA_SENSORES:
+            ssd1306_load_frame(t->ssd, t->modelo[tela]);
+            desenhar_sensores(t->ssd, d);
+            break;
+        case TELA_WIFI:
+        default:
+            ssd1306_load_frame(t->ssd, t->modelo[TELA_WIFI]);
+            desenhar_wifi(t->ssd, d);
+            break;
+    }
+    t->desenhada = tela;
+}
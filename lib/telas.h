@@ -0,0 +1,62 @@
+#ifndef TELAS_H
+#define TELAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+#include "tendencia.h"
+
+// Telas do display: montam o quadro no buffer do SSD1306 e não tocam o barramento
+// (o envio fica com o chamador). Sem outra dependência do SDK, rodam também no host.
+
+// Ordem do ciclo do botão B; as telas até TELA_WIFI são desenhadas sobre um modelo fixo
+typedef enum {
+    TELA_SENSORES,
+    TELA_WIFI,
+    TELA_GRAFICO_TEMPERATURA,
+    TELA_GRAFICO_PRESSAO,
+    NUM_TELAS
+} TipoTela;
+
+#define NUM_MODELOS_TELA (TELA_WIFI + 1)
+
+// Área dos gráficos: páginas 1..7; a página 0 mostra o valor atual
+#define GRAFICO_PAGINA 1
+#define GRAFICO_Y (GRAFICO_PAGINA * 8)
+#define GRAFICO_ALTURA (HEIGHT - GRAFICO_Y)
+
+// O que as telas mostram, nas unidades internas
+typedef struct {
+    int32_t temperatura;        // 0.01 °C
+    int32_t umidade;            // 0.01 %
+    int32_t pressao;            // Pa
+    int32_t altitude;           // dm
+    bool temp_umid_obsoletas;   // sem leitura boa recente: mostradas como "--"
+    bool pressao_obsoleta;      // vale também para a altitude
+    bool wifi_conectado;
+    const char *ip;
+    const char *status;         // grandeza selecionada pelo botão A
+    Tendencia *tendencia_temperatura;  // os gráficos zeram 'novos' e 'reescalar'
+    Tendencia *tendencia_pressao;
+} DadosTela;
+
+typedef struct {
+    ssd1306_t *ssd;
+    // Moldura e rótulos fixos de cada tela, desenhados uma vez e copiados a cada quadro
+    uint8_t modelo[NUM_MODELOS_TELA][WIDTH * HEIGHT / 8];
+    // Tela cujo conteúdo está no buffer do display; os gráficos só desenham o que mudou nele
+    TipoTela desenhada;
+} Telas;
+
+// Desenha os modelos (usa o buffer do display como rascunho)
+void telas_init(Telas *t, ssd1306_t *ssd);
+
+// Monta a tela no buffer do display
+void telas_desenhar(Telas *t, TipoTela tela, const DadosTela *d);
+
+// Outro conteúdo foi desenhado por cima (ex.: avisos do Wi-Fi): o próximo gráfico é completo
+static inline void telas_invalidar(Telas *t) {
+    t->desenhada = NUM_TELAS;
+}
+
+#endif // TELAS_H
@@ -0,0 +1,94 @@
+#include "tendencia.h"
+
+void tendencia_init(Tendencia *t, uint32_t periodo_ms, int32_t passo) {
+    t->inicio = 0;
+    t->n = 0;
+    t->periodo_ms = periodo_ms;
+    t->soma = 0;
+    t->contagem = 0;
+    t->abertura_ms = 0;
+    t->passo = passo > 0 ? passo : 1;
+    t->escala_min = 0;
+    t->escala_max = t->passo;
+    t->novos = 0;
+    t->reescalar = true;
+}
+
+// Arredonda para baixo/cima em múltiplos de passo, inclusive para negativos
+static int32_t piso(int32_t v, int32_t passo) {
+    int32_t r = v % passo;
+    return r < 0 ? v - r - passo : v - r;
+}
+
+static int32_t teto(int32_t v, int32_t passo) {
+    int32_t p = piso(v, passo);
+    return p == v ? v : p + passo;
+}
+
+static void tendencia_atualizar_escala(Tendencia *t) {
+    int32_t min = tendencia_ponto(t, 0), max = min;
+    for (uint8_t i = 1; i < t->n; i++) {
+        int32_t v = tendencia_ponto(t, i);
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+    min = piso(min, t->passo);
+    max = teto(max, t->passo);
+    if (max == min) {
+        max += t->passo;
+    }
+    if (min != t->escala_min || max != t->escala_max) {
+        t->escala_min = min;
+        t->escala_max = max;
+        t->reescalar = true;
+    }
+}
+
+static void tendencia_fechar(Tendencia *t) {
+    int32_t media = (int32_t)(t->soma / (int64_t)t->contagem);
+    if (t->n < TENDENCIA_PONTOS) {
+        t->pontos[(t->inicio + t->n) % TENDENCIA_PONTOS] = media;
+        t->n++;
+    } else {
+        t->pontos[t->inicio] = media;
+        t->inicio = (t->inicio + 1) % TENDENCIA_PONTOS;
+    }
+    if (t->novos < TENDENCIA_PONTOS) {
+        t->novos++;
+    }
+    tendencia_atualizar_escala(t);
+}
+
+bool tendencia_adicionar(Tendencia *t, int32_t valor, uint32_t t_ms) {
+    bool fechou = false;
+    if (t->contagem && t_ms - t->abertura_ms >= t->periodo_ms) {
+        tendencia_fechar(t);
+        t->soma = 0;
+        t->contagem = 0;
+        fechou = true;
+    }
+    if (t->contagem == 0) {
+        t->abertura_ms = t_ms;
+    }
+    t->soma += valor;
+    t->contagem++;
+    return fechou;
+}
+
+void tendencia_deslocar(Tendencia *t, int32_t delta) {
+    for (uint8_t i = 0; i < t->n; i++) {
+        t->pontos[(t->inicio + i) % TENDENCIA_PONTOS] += delta;
+    }
+    t->soma += (int64_t)delta * t->contagem;
+    if (t->n) {
+        tendencia_atualizar_escala(t);
+    }
+}
+
+uint8_t tendencia_linha(const Tendencia *t, int32_t valor, uint8_t altura) {
+    if (valor <= t->escala_min) return altura - 1;
+    if (valor >= t->escala_max) return 0;
+    int64_t acima = (int64_t)(valor - t->escala_min) * (altura - 1);
+    int32_t faixa = t->escala_max - t->escala_min;
+    return (uint8_t)(altura - 1 - (acima + faixa / 2) / faixa);
+}
@@ -0,0 +1,52 @@
+#ifndef TENDENCIA_H
+#define TENDENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Série histórica para os gráficos do display: as amostras são agregadas em pontos de
+// período fixo (média) guardados num anel. Não depende do SDK.
+
+// Um ponto por coluna do display
+#define TENDENCIA_PONTOS 128
+
+typedef struct {
+    int32_t pontos[TENDENCIA_PONTOS];
+    uint8_t inicio;          // índice do ponto mais antigo
+    uint8_t n;
+    uint32_t periodo_ms;
+
+    // Ponto em formação
+    int64_t soma;
+    uint32_t contagem;
+    uint32_t abertura_ms;
+
+    // Escala: mínimo e máximo da série arredondados para fora em múltiplos de 'passo',
+    // para que ela só mude quando a série sair da faixa atual
+    int32_t passo;
+    int32_t escala_min;
+    int32_t escala_max;
+
+    // Para o consumidor (display), que os zera depois de desenhar
+    uint8_t novos;           // pontos fechados desde o último desenho (satura em TENDENCIA_PONTOS)
+    bool reescalar;          // a escala mudou: redesenhar a série inteira
+} Tendencia;
+
+void tendencia_init(Tendencia *t, uint32_t periodo_ms, int32_t passo);
+
+// Acumula uma amostra colhida em t_ms. Ao passar do período fecha o ponto com a média
+// do que foi acumulado e retorna true. Sem amostras (sensor obsoleto) não há pontos.
+bool tendencia_adicionar(Tendencia *t, int32_t valor, uint32_t t_ms);
+
+// i-ésimo ponto, 0 = mais antigo
+static inline int32_t tendencia_ponto(const Tendencia *t, uint8_t i) {
+    return t->pontos[(t->inicio + i) % TENDENCIA_PONTOS];
+}
+
+// Soma delta a toda a série (troca de offset de calibração); a escala é recalculada
+void tendencia_deslocar(Tendencia *t, int32_t delta);
+
+// Linha do valor numa área de 'altura' linhas (0 = topo = escala_max)
+uint8_t tendencia_linha(const Tendencia *t, int32_t valor, uint8_t altura);
+
+#endif // TENDENCIA_H
@@ -0,0 +1,173 @@
+#include <string.h>
+#include "host.h"
+#include "barramento_falso.h"
+
+i2c_inst_t i2c0_inst = {0}, i2c1_inst = {1};
+
+typedef struct {
+    uint8_t addr;
+    dispositivo_falso_t fn;
+    void *ctx;
+} Conexao;
+
+#define MAX_CONEXOES 16
+
+// Estado de cada controlador: dispositivos, registro e a transação da fila em curso
+static struct {
+    Conexao conexoes[MAX_CONEXOES];
+    uint8_t num_conexoes;
+    RegistroBarramento registro;
+    i2c_queue_t *fila;
+    bool ocupado;
+    uint64_t fim_us;
+    i2c_txn_status_t resultado;
+} barramentos[2];
+
+void barramento_falso_conectar(i2c_inst_t *i2c, uint8_t addr, dispositivo_falso_t fn, void *ctx) {
+    Conexao *c = &barramentos[i2c->indice].conexoes[barramentos[i2c->indice].num_conexoes++];
+    c->addr = addr;
+    c->fn = fn;
+    c->ctx = ctx;
+}
+
+void barramento_falso_zerar(void) {
+    memset(barramentos, 0, sizeof(barramentos));
+}
+
+const RegistroBarramento *barramento_falso_registro(i2c_inst_t *i2c) {
+    return &barramentos[i2c->indice].registro;
+}
+
+static const Conexao *procurar(uint8_t indice, uint8_t addr) {
+    for (uint8_t i = 0; i < barramentos[indice].num_conexoes; i++) {
+        if (barramentos[indice].conexoes[i].addr == addr) {
+            return &barramentos[indice].conexoes[i];
+        }
+    }
+    return NULL;
+}
+
+static void registrar(uint8_t indice, uint8_t addr, size_t bytes) {
+    RegistroBarramento *r = &barramentos[indice].registro;
+    r->enderecos[r->transacoes % BARRAMENTO_FALSO_REGISTRO] = addr;
+    r->transacoes++;
+    r->bytes += bytes;
+}
+
+// Entrega um fluxo pré-montado ao dispositivo, um trecho por repeated start
+static i2c_txn_status_t executar_fluxo(const Conexao *c, const uint16_t *fluxo, uint16_t len) {
+    static uint8_t trecho[BARRAMENTO_FALSO_MAX_TRECHO];
+    size_t n = 0;
+    for (uint16_t i = 0; i <= len; i++) {
+        if (i == len || (i > 0 && (fluxo[i] & I2C_IC_DATA_CMD_RESTART_BITS))) {
+            i2c_txn_status_t s = c->fn(c->ctx, trecho, n, NULL, 0);
+            if (s != I2C_TXN_OK || i == len) {
+                return s;
+            }
+            n = 0;
+        }
+        if (n < sizeof(trecho)) {
+            trecho[n++] = (uint8_t)fluxo[i];
+        }
+    }
+    return I2C_TXN_OK;
+}
+
+static void falso_start(i2c_queue_t *q, i2c_txn_t *txn) {
+    uint8_t indice = q->i2c->indice;
+    const Conexao *c = procurar(indice, txn->addr);
+    size_t bytes = 1 + (txn->stream ? txn->stream_len : (size_t)txn->tx_len + txn->rx_len);
+
+    i2c_txn_status_t s = I2C_TXN_NACK;
+    if (c) {
+        s = txn->stream ? executar_fluxo(c, txn->stream, txn->stream_len)
+                        : c->fn(c->ctx, txn->tx, txn->tx_len, txn->rx, txn->rx_len);
+    }
+    registrar(indice, txn->addr, bytes);
+
+    barramentos[indice].ocupado = true;
+    barramentos[indice].resultado = s;
+    // NACK no endereço aparece logo no primeiro byte
+    barramentos[indice].fim_us = time_us_64() + (s == I2C_TXN_NACK ? 1 : bytes) * BARRAMENTO_FALSO_US_POR_BYTE;
+}
+
+static void falso_abort(i2c_queue_t *q) {
+    barramentos[q->i2c->indice].ocupado = false;
+    barramentos[q->i2c->indice].registro.abortos++;
+}
+
+static void falso_recover(i2c_queue_t *q) {
+    barramentos[q->i2c->indice].ocupado = false;
+    barramentos[q->i2c->indice].registro.recuperacoes++;
+}
+
+void i2c_queue_init_falso(i2c_queue_t *q, i2c_inst_t *i2c) {
+    memset(q, 0, sizeof(*q));
+    q->retry_budget = I2C_QUEUE_RETRY_BUDGET;
+    q->start = falso_start;
+    q->abort = falso_abort;
+    q->recover = falso_recover;
+    q->i2c = i2c;
+    barramentos[i2c->indice].fila = q;
+}
+
+void barramento_falso_atender(void) {
+    for (uint8_t i = 0; i < 2; i++) {
+        // Um escravo travado (TIMEOUT) não conclui: fica para o watchdog da fila
+        while (barramentos[i].ocupado && barramentos[i].resultado != I2C_TXN_TIMEOUT &&
+               time_us_64() >= barramentos[i].fim_us) {
+            barramentos[i].ocupado = false;
+            // A conclusão pode iniciar a próxima transação, que volta a ocupar o barramento
+            i2c_queue_complete(barramentos[i].fila, barramentos[i].resultado);
+        }
+    }
+}
+
+// Escritas bloqueantes do SDK (display sem fila): concluem na hora, com o tempo do barramento
+int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop, uint timeout_us) {
+    const Conexao *c = procurar(i2c->indice, addr);
+    registrar(i2c->indice, addr, 1 + len);
+    if (!c) {
+        return PICO_ERROR_GENERIC;
+    }
+    uint64_t duracao = (1 + len) * BARRAMENTO_FALSO_US_POR_BYTE;
+    if (c->fn(c->ctx, src, len, NULL, 0) != I2C_TXN_OK) {
+        host_avancar_us(timeout_us);
+        return PICO_ERROR_TIMEOUT;
+    }
+    host_avancar_us(duracao > timeout_us ? timeout_us : duracao);
+    return duracao > timeout_us ? PICO_ERROR_TIMEOUT : (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return i2c_write_timeout_us(i2c, addr, src, len, nostop, UINT32_MAX);
+}
+
+int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop, uint timeout_us) {
+    const Conexao *c = procurar(i2c->indice, addr);
+    registrar(i2c->indice, addr, 1 + len);
+    if (!c || c->fn(c->ctx, NULL, 0, dst, len) != I2C_TXN_OK) {
+        return PICO_ERROR_GENERIC;
+    }
+    host_avancar_us((1 + len) * BARRAMENTO_FALSO_US_POR_BYTE);
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    return i2c_read_timeout_us(i2c, addr, dst, len, nostop, UINT32_MAX);
+}
+
+i2c_txn_status_t dispositivo_registradores(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    DispositivoRegistradores *d = ctx;
+    if (tx_len) {
+        d->ponteiro = tx[0];
+        for (size_t i = 1; i < tx_len; i++) {
+            d->reg[d->ponteiro++] = tx[i];
+            d->escritas++;
+        }
+    }
+    for (size_t i = 0; i < rx_len; i++) {
+        rx[i] = d->reg[d->ponteiro++];
+    }
+    return I2C_TXN_OK;
+}
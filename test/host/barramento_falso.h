@@ -0,0 +1,57 @@
+#ifndef BARRAMENTO_FALSO_H
+#define BARRAMENTO_FALSO_H
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "i2c_queue.h"
+
+// Barramento I2C emulado para os testes no host. Dispositivos conectados por endereço
+// respondem tanto às transações da fila (backend falso) quanto às escritas bloqueantes
+// do SDK. Endereço sem dispositivo responde NACK.
+
+// Tempo de um byte no barramento a 400 kHz (9 bits), arredondado para cima
+#define BARRAMENTO_FALSO_US_POR_BYTE 23
+// Maior trecho de um fluxo pré-montado entregue ao dispositivo
+#define BARRAMENTO_FALSO_MAX_TRECHO 2048
+// Transações lembradas no registro (as mais antigas se perdem)
+#define BARRAMENTO_FALSO_REGISTRO 256
+
+// Uma transação como o dispositivo a vê: escrita seguida de leitura opcional com
+// repeated start. Num fluxo pré-montado cada trecho entre repeated starts chega numa
+// chamada separada. I2C_TXN_TIMEOUT simula um escravo que segura o barramento.
+typedef i2c_txn_status_t (*dispositivo_falso_t)(void *ctx, const uint8_t *tx, size_t tx_len,
+                                                uint8_t *rx, size_t rx_len);
+
+// O que passou por um controlador desde o último barramento_falso_zerar
+typedef struct {
+    uint8_t enderecos[BARRAMENTO_FALSO_REGISTRO];  // na ordem em que foram ao barramento
+    uint32_t transacoes;
+    uint32_t bytes;        // bytes no barramento, endereço incluído
+    uint32_t abortos;
+    uint32_t recuperacoes;
+} RegistroBarramento;
+
+void barramento_falso_conectar(i2c_inst_t *i2c, uint8_t addr, dispositivo_falso_t fn, void *ctx);
+// Desconecta todos os dispositivos e zera os registros
+void barramento_falso_zerar(void);
+const RegistroBarramento *barramento_falso_registro(i2c_inst_t *i2c);
+
+// Backend falso da fila: cada transação ocupa o barramento pelo tempo que levaria a
+// 400 kHz e termina quando o relógio virtual passa desse ponto
+void i2c_queue_init_falso(i2c_queue_t *q, i2c_inst_t *i2c);
+
+// Conclui as transações cujo tempo já passou (chamado pelo relógio virtual)
+void barramento_falso_atender(void);
+
+// Dispositivo de registradores com ponteiro auto-incrementado (BMP280, SSD1306 em
+// modo registrador etc.): o primeiro byte escrito posiciona o ponteiro, os seguintes
+// gravam; a leitura começa no ponteiro
+typedef struct {
+    uint8_t reg[256];
+    uint8_t ponteiro;
+    uint32_t escritas;
+} DispositivoRegistradores;
+
+i2c_txn_status_t dispositivo_registradores(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+#endif // BARRAMENTO_FALSO_H
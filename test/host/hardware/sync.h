@@ -0,0 +1,15 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// Um só fluxo de execução no host: o barramento emulado conclui as transações nas
+// esperas, nunca no meio de uma seção crítica. Antes de desabilitar, roda uma vez a
+// interrupção pendente de host_irq_pendente (host.h), se houver.
+uint32_t save_and_disable_interrupts(void);
+static inline void restore_interrupts(uint32_t estado) { (void)estado; }
+
+#define __dmb() __sync_synchronize()
+#define __compiler_memory_barrier() __asm__ volatile("" ::: "memory")
+
+#endif // HOST_HARDWARE_SYNC_H
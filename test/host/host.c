@@ -0,0 +1,52 @@
+#include <time.h>
+#include "host.h"
+#include "barramento_falso.h"
+
+int host_falhas;
+void (*host_irq_pendente)(void);
+
+static uint64_t relogio_us;
+
+uint64_t time_us_64(void) {
+    return relogio_us;
+}
+
+void host_avancar_us(uint64_t us) {
+    relogio_us += us;
+    barramento_falso_atender();
+}
+
+void host_definir_us(uint64_t us) {
+    relogio_us = us;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    void (*irq)(void) = host_irq_pendente;
+    host_irq_pendente = NULL;
+    if (irq) {
+        irq();
+    }
+    return 0;
+}
+
+void tight_loop_contents(void) {
+    host_avancar_us(1);
+}
+
+void busy_wait_us(uint64_t us) {
+    host_avancar_us(us);
+}
+
+void sleep_us(uint64_t us) {
+    host_avancar_us(us);
+}
+
+void sleep_ms(uint32_t ms) {
+    host_avancar_us((uint64_t)ms * 1000);
+}
+
+double host_agora_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e9 + t.tv_nsec;
+}
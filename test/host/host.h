@@ -0,0 +1,50 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+
+// Apoio aos testes no host: relógio virtual, verificações e cronômetro das bancadas
+
+// Avança o relógio virtual, concluindo as transações do barramento emulado no caminho
+void host_avancar_us(uint64_t us);
+// Volta o relógio a 'us' sem atender o barramento (início de um cenário)
+void host_definir_us(uint64_t us);
+
+// Interrupção que chega logo antes da próxima seção crítica (roda uma vez e é limpa),
+// para exercitar corridas entre o laço principal e a IRQ
+extern void (*host_irq_pendente)(void);
+
+// Tempo de parede em ns, para as bancadas (o relógio virtual não mede custo de CPU)
+double host_agora_ns(void);
+
+extern int host_falhas;
+
+// Registra a falha e segue: um teste mostra todas as divergências de uma vez
+#define VERIFICAR(cond, ...)                                          \
+    do {                                                              \
+        if (!(cond)) {                                                \
+            printf("FALHA %s:%d: %s: ", __FILE__, __LINE__, #cond);   \
+            printf(__VA_ARGS__);                                      \
+            printf("\n");                                             \
+            host_falhas++;                                            \
+        }                                                             \
+    } while (0)
+
+// Código de saída do teste para o ctest
+static inline int host_resultado(void) {
+    printf("%s\n", host_falhas ? "FALHOU" : "OK");
+    return host_falhas ? 1 : 0;
+}
+
+// Executa 'corpo' 'n' vezes e retorna o custo médio por repetição em ns
+#define BANCADA_NS(n, corpo)                              \
+    ({                                                    \
+        double _t0 = host_agora_ns();                     \
+        for (uint32_t _i = 0; _i < (uint32_t)(n); ++_i) { \
+            corpo;                                        \
+        }                                                 \
+        (host_agora_ns() - _t0) / (double)(n);            \
+    })
+
+#endif // HOST_H
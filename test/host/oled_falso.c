@@ -0,0 +1,129 @@
+#include <string.h>
+#include "oled_falso.h"
+
+void oled_falso_init(OledFalso *o) {
+    memset(o, 0, sizeof(*o));
+    // Conteúdo indefinido depois de ligar: um padrão que nenhum quadro real tem
+    memset(o->gddram, 0xA5, sizeof(o->gddram));
+    o->modo = 2;  // padrão do controlador depois do reset
+    o->col1 = OLED_FALSO_COLUNAS - 1;
+    o->pag1 = OLED_FALSO_PAGINAS - 1;
+    o->semente = 1;
+}
+
+// Argumentos de cada comando de vários bytes do SSD1306
+static uint8_t argumentos(uint8_t c) {
+    switch (c) {
+        case 0x21: case 0x22: return 2;                      // endereços de coluna e página
+        case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+        case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+        default: return 0;
+    }
+}
+
+static void executar(OledFalso *o) {
+    switch (o->comando) {
+        case 0x20:
+            o->modo = o->args[0] & 3;
+            break;
+        case 0x21:
+            o->col0 = o->col = o->args[0] & 0x7F;
+            o->col1 = o->args[1] & 0x7F;
+            break;
+        case 0x22:
+            o->pag0 = o->pag = o->args[0] & 7;
+            o->pag1 = o->args[1] & 7;
+            break;
+        case 0xAE: o->ligado = false; break;
+        case 0xAF: o->ligado = true; break;
+        default:
+            // Modo página: início da coluna em dois nibbles e página em B0..B7
+            if (o->comando <= 0x0F) o->col = (o->col & 0xF0) | o->comando;
+            else if (o->comando >= 0x10 && o->comando <= 0x1F) o->col = (o->col & 0x0F) | ((o->comando & 0x0F) << 4);
+            else if (o->comando >= 0xB0 && o->comando <= 0xB7) o->pag = o->comando & 7;
+            break;
+    }
+}
+
+static void comando(OledFalso *o, uint8_t b) {
+    if (o->args_faltando) {
+        o->args[argumentos(o->comando) - o->args_faltando] = b;
+        if (--o->args_faltando == 0) executar(o);
+        return;
+    }
+    o->comando = b;
+    o->args_faltando = argumentos(b);
+    if (o->args_faltando == 0) executar(o);
+}
+
+static void dado(OledFalso *o, uint8_t b) {
+    o->gddram[o->pag & 7][o->col & 0x7F] = b;
+    o->bytes_dados++;
+    switch (o->modo) {
+        case 0:  // horizontal: colunas, depois a página seguinte
+            if (o->col++ >= o->col1) {
+                o->col = o->col0;
+                o->pag = o->pag >= o->pag1 ? o->pag0 : o->pag + 1;
+            }
+            break;
+        case 1:  // vertical: páginas, depois a coluna seguinte
+            if (o->pag++ >= o->pag1) {
+                o->pag = o->pag0;
+                o->col = o->col >= o->col1 ? o->col0 : o->col + 1;
+            }
+            break;
+        default:  // página: só a coluna anda, e volta ao início da linha
+            o->col = (o->col + 1) & 0x7F;
+            break;
+    }
+}
+
+static uint32_t aleatorio(OledFalso *o) {
+    o->semente ^= o->semente << 13;
+    o->semente ^= o->semente >> 17;
+    o->semente ^= o->semente << 5;
+    return o->semente;
+}
+
+i2c_txn_status_t oled_falso_dispositivo(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    OledFalso *o = ctx;
+    o->escritas++;
+    // Um comando cortado no meio não continua na transação seguinte
+    o->args_faltando = 0;
+    if (tx_len == 0) {
+        return I2C_TXN_OK;
+    }
+    // Falha no meio da escrita: o painel fica com só uma parte do que foi enviado
+    size_t n = tx_len;
+    bool falhou = o->falha_permil && aleatorio(o) % 1000 < o->falha_permil;
+    if (falhou) {
+        n = aleatorio(o) % tx_len;
+        o->falhas++;
+    }
+
+    // Byte de controle: Co (bit 7) = um só byte a seguir, D/C (bit 6) = dados
+    size_t i = 0;
+    while (i < n) {
+        uint8_t controle = tx[i++];
+        bool so_um = controle & 0x80, dados = controle & 0x40;
+        for (; i < n; i++) {
+            if (dados) dado(o, tx[i]);
+            else comando(o, tx[i]);
+            if (so_um) {
+                i++;
+                break;
+            }
+        }
+    }
+    return falhou ? I2C_TXN_NACK : I2C_TXN_OK;
+}
+
+uint32_t oled_falso_comparar(const OledFalso *o, const uint8_t *quadro, uint8_t largura, uint8_t paginas) {
+    uint32_t diferentes = 0;
+    for (uint8_t x = 0; x < largura; x++) {
+        for (uint8_t p = 0; p < paginas; p++) {
+            if (o->gddram[p][x] != quadro[(uint16_t)x * paginas + p]) diferentes++;
+        }
+    }
+    return diferentes;
+}
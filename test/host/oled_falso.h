@@ -0,0 +1,47 @@
+#ifndef OLED_FALSO_H
+#define OLED_FALSO_H
+
+#include "barramento_falso.h"
+
+// Emulação do controlador SSD1306 no barramento falso: interpreta o byte de controle
+// (0x00/0x80 comandos, 0x40 dados), os comandos de endereçamento e grava os dados na
+// GDDRAM com o auto-incremento do modo em uso, como o painel faria. O que estiver na
+// GDDRAM é o que o usuário veria.
+
+#define OLED_FALSO_COLUNAS 128
+#define OLED_FALSO_PAGINAS 8
+
+typedef struct {
+    uint8_t gddram[OLED_FALSO_PAGINAS][OLED_FALSO_COLUNAS];
+    uint8_t modo;             // SET_MEM_ADDR: 0 horizontal, 1 vertical, 2 página
+    uint8_t col0, col1, pag0, pag1;
+    uint8_t col, pag;         // ponteiro de escrita
+    bool ligado;
+
+    // Comando de vários bytes em andamento; um START novo o descarta
+    uint8_t comando;
+    uint8_t args[2];
+    uint8_t args_faltando;
+
+    uint32_t bytes_dados;     // bytes gravados na GDDRAM
+    uint32_t escritas;        // transações recebidas (trechos de um fluxo contam separados)
+
+    // Falha injetada: a cada escrita, chance por mil de gravar só um prefixo e responder NACK
+    uint16_t falha_permil;
+    uint32_t semente;
+    uint32_t falhas;
+} OledFalso;
+
+void oled_falso_init(OledFalso *o);
+
+i2c_txn_status_t oled_falso_dispositivo(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len);
+
+static inline bool oled_falso_pixel(const OledFalso *o, uint8_t x, uint8_t y) {
+    return (o->gddram[y >> 3][x] >> (y & 7)) & 1;
+}
+
+// Compara a GDDRAM com um quadro no layout do driver (coluna a coluna, 'paginas' bytes
+// por coluna); retorna o número de bytes diferentes
+uint32_t oled_falso_comparar(const OledFalso *o, const uint8_t *quadro, uint8_t largura, uint8_t paginas);
+
+#endif // OLED_FALSO_H
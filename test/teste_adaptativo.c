@@ -0,0 +1,131 @@
+#include "host.h"
+#include "adaptativo.h"
+#include "estatistica.h"
+#include "simulador.h"
+#include "tendencia.h"
+
+// Taxa adaptativa alimentada pelo simulador, com a mesma configuração do firmware
+
+enum { TEMP, UMID, PRESSAO, NUM };
+
+static const ConfigAdaptativo CFG = {
+    .num_canais = NUM,
+    .limiar_por_min = {[TEMP] = 50, [UMID] = 300, [PRESSAO] = 30},
+    .base_ms = 30000,
+    .espera_ms = 60000,
+    .num_niveis = 4,
+    .nivel_inicial = 1,
+};
+// Período de amostragem de cada nível (ms)
+static const uint32_t PERIODO[] = {250, 1000, 2000, 5000};
+
+typedef struct {
+    uint32_t amostras;
+    uint32_t tempo_nivel0_ms;   // tempo passado na taxa mais rápida
+    uint32_t primeira_aceleracao_ms;
+    uint8_t canal;
+} Rodada;
+
+// Roda o perfil por 'duracao_ms' de tempo real, amostrando no período do nível atual
+static Rodada rodar(const PerfilClima *perfil, uint32_t duracao_ms, Adaptativo *a) {
+    Simulador s;
+    simulador_init(&s, perfil, 7);
+    adaptativo_init(a, &CFG, 0);
+    Rodada r = {0, 0, UINT32_MAX, 0};
+    for (uint32_t t = 0; t < duracao_ms;) {
+        uint32_t periodo = PERIODO[a->nivel];
+        EstadoClima e;
+        if (simulador_medir(&s, t, &e)) {
+            r.amostras++;
+            bool mudou = adaptativo_atualizar(a, TEMP, e.temperatura, t);
+            mudou |= adaptativo_atualizar(a, UMID, e.umidade, t);
+            mudou |= adaptativo_atualizar(a, PRESSAO, e.pressao, t);
+            if (mudou && a->nivel == 0 && r.primeira_aceleracao_ms == UINT32_MAX) {
+                r.primeira_aceleracao_ms = t;
+                r.canal = a->canal_motivo;
+            }
+        }
+        if (a->nivel == 0) r.tempo_nivel0_ms += periodo;
+        t += periodo;
+    }
+    return r;
+}
+
+static void testar_estavel(void) {
+    Adaptativo a;
+    Rodada r = rodar(&PERFIL_ESTAVEL, 3600000, &a);
+    printf("estável: %u amostras em 1 h, nível final %u, %u trocas\n", (unsigned)r.amostras, a.nivel,
+           (unsigned)a.trocas);
+    VERIFICAR(a.nivel == 3 && a.motivo == MOTIVO_ESTAVEL, "nível %u motivo %d", a.nivel, a.motivo);
+    VERIFICAR(a.trocas == 2 && r.tempo_nivel0_ms == 0, "%u trocas, %u ms no nível 0", (unsigned)a.trocas,
+              (unsigned)r.tempo_nivel0_ms);
+}
+
+static void testar_frente(void) {
+    // Frente de 30 min a cada 3 h em tempo real: 1200 Pa em 15 min passa dos 30 Pa/min
+    PerfilClima p = PERFIL_FRENTE_FRIA;
+    p.aceleracao = 1;
+    p.frente_periodo_s = 3 * 3600;
+    p.frente_duracao_s = 1800;
+    Adaptativo a;
+    Rodada r = rodar(&p, 3 * 3600000, &a);
+    printf("frente: acelerou em %u s pelo canal %u, %u s no nível 0, %u trocas\n",
+           (unsigned)(r.primeira_aceleracao_ms / 1000), r.canal, (unsigned)(r.tempo_nivel0_ms / 1000),
+           (unsigned)a.trocas);
+    VERIFICAR(r.primeira_aceleracao_ms < 300000 && r.canal == PRESSAO, "aceleração em %u ms pelo canal %u",
+              (unsigned)r.primeira_aceleracao_ms, r.canal);
+    VERIFICAR(r.tempo_nivel0_ms >= 1500000 && r.tempo_nivel0_ms <= 2400000, "%u s no nível 0",
+              (unsigned)(r.tempo_nivel0_ms / 1000));
+    VERIFICAR(a.nivel == 3, "nível %u depois da frente", a.nivel);
+}
+
+// Troca de offset no meio de uma série estável: com o deslocamento das referências o
+// degrau não acelera a amostragem nem conta como espúria; sem ele, acelera
+static void testar_offset(bool deslocar) {
+    Adaptativo a;
+    adaptativo_init(&a, &CFG, 0);
+    CanalEstat c;
+    canal_estat_init(&c, 200);
+    Tendencia tend;
+    tendencia_init(&tend, 10000, 50);
+
+    int32_t offset = 0;
+    uint32_t acelerou = 0;
+    int32_t filtrada = 0;
+    for (uint32_t t = 0; t < 600000; t += 1000) {
+        if (t == 300000) {
+            int32_t novo = 500;
+            if (deslocar) {
+                canal_estat_deslocar(&c, novo - offset);
+                adaptativo_deslocar(&a, PRESSAO, novo - offset);
+                tendencia_deslocar(&tend, novo - offset);
+            }
+            offset = novo;
+        }
+        filtrada = canal_estat_atualizar(&c, 101000 + (int32_t)(t / 1000 % 3) + offset, t);
+        tendencia_adicionar(&tend, filtrada, t);
+        if (adaptativo_atualizar(&a, PRESSAO, filtrada, t) && a.nivel == 0) acelerou++;
+        if (deslocar && t >= 300000) {
+            VERIFICAR(filtrada >= 101500 && filtrada <= 101502, "t=%u: filtrada %d", (unsigned)t, (int)filtrada);
+        }
+    }
+    ResumoEstat r;
+    canal_estat_resumo(&c, JANELA_10MIN, &r);
+    if (deslocar) {
+        VERIFICAR(acelerou == 0 && a.nivel == 3, "acelerou %u vezes, nível %u", (unsigned)acelerou, a.nivel);
+        VERIFICAR(c.espurias == 0, "%u espúrias", (unsigned)c.espurias);
+        VERIFICAR(r.min >= 101500 && r.desvio <= 1, "janela min %d desvio %d", (int)r.min, (int)r.desvio);
+        VERIFICAR(tendencia_ponto(&tend, 0) >= 101500 && tend.escala_min == 101500,
+                  "gráfico: primeiro ponto %d, escala %d", (int)tendencia_ponto(&tend, 0), (int)tend.escala_min);
+    } else {
+        VERIFICAR(acelerou == 1, "sem deslocar, o degrau deveria acelerar (acelerou %u)", (unsigned)acelerou);
+    }
+}
+
+int main(void) {
+    testar_estavel();
+    testar_frente();
+    testar_offset(false);
+    testar_offset(true);
+    return host_resultado();
+}
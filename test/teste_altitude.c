@@ -0,0 +1,65 @@
+#include <math.h>
+#include "host.h"
+#include "altitude.h"
+
+// Altitude em ponto fixo contra 44330 * (1 - (p/p0)^0.1903) em double: os limites de erro
+// documentados em altitude.h, a saturação fora da tabela e o custo frente ao pow()
+
+static double altitude_double_dm(double p, double p0) {
+    return 443300.0 * (1.0 - pow(p / p0, 0.1903));
+}
+
+// Maior erro em metros entre p_min e p_max para a referência p0
+static double erro_maximo_m(uint32_t p0, uint32_t p_min, uint32_t p_max) {
+    altitude_definir_referencia(p0);
+    double erro = 0;
+    for (uint32_t p = p_min; p <= p_max; p += 3) {
+        erro = fmax(erro, fabs(altitude_calcular_dm(p) - altitude_double_dm(p, p0)) / 10.0);
+    }
+    return erro;
+}
+
+static void testar_erro(void) {
+    double pior = 0, pior_alto = 0;
+    for (uint32_t p0 = 95000; p0 <= 105000; p0 += 250) {
+        pior = fmax(pior, erro_maximo_m(p0, ALTITUDE_PRESSAO_MIN_PA, ALTITUDE_PRESSAO_MAX_PA));
+        pior_alto = fmax(pior_alto, erro_maximo_m(p0, 60000, ALTITUDE_PRESSAO_MAX_PA));
+    }
+    printf("erro max: %.3f m em 30-110 kPa, %.3f m em 60-110 kPa (p0 de 95 a 105 kPa)\n", pior, pior_alto);
+    VERIFICAR(pior <= 0.19, "%.3f m", pior);
+    VERIFICAR(pior_alto <= 0.13, "%.3f m", pior_alto);
+}
+
+static void testar_referencia(void) {
+    // Na própria referência a altitude é zero; acima dela, negativa
+    altitude_definir_referencia(ALTITUDE_REFERENCIA_PADRAO_PA);
+    VERIFICAR(altitude_calcular_dm(ALTITUDE_REFERENCIA_PADRAO_PA) == 0, "%d dm",
+              (int)altitude_calcular_dm(ALTITUDE_REFERENCIA_PADRAO_PA));
+    VERIFICAR(altitude_calcular_dm(102000) < 0, "acima de p0 deu %d dm", (int)altitude_calcular_dm(102000));
+
+    // Trocar a referência desloca a curva: 90 kPa fica mais alto com p0 maior
+    int32_t h_padrao = altitude_calcular_dm(90000);
+    altitude_definir_referencia(102500);
+    int32_t h_alta = altitude_calcular_dm(90000);
+    VERIFICAR(h_alta > h_padrao, "%d <= %d", (int)h_alta, (int)h_padrao);
+
+    // Fora da tabela a pressão satura nas bordas
+    VERIFICAR(altitude_calcular_dm(1000) == altitude_calcular_dm(ALTITUDE_PRESSAO_MIN_PA), "abaixo da faixa");
+    VERIFICAR(altitude_calcular_dm(200000) == altitude_calcular_dm(ALTITUDE_PRESSAO_MAX_PA), "acima da faixa");
+}
+
+static void bancada(void) {
+    const uint32_t n = 4000000;
+    volatile int64_t soma = 0;
+    altitude_definir_referencia(ALTITUDE_REFERENCIA_PADRAO_PA);
+    double ns_fixo = BANCADA_NS(n, soma += altitude_calcular_dm(30000 + _i % 80000));
+    double ns_pow = BANCADA_NS(n, soma += (int64_t)altitude_double_dm(30000 + _i % 80000, 101325.0));
+    printf("bancada: altitude_calcular_dm %.1f ns, pow() em double %.1f ns\n", ns_fixo, ns_pow);
+}
+
+int main(void) {
+    testar_erro();
+    testar_referencia();
+    bancada();
+    return host_resultado();
+}
@@ -0,0 +1,167 @@
+#include <math.h>
+#include <string.h>
+#include "host.h"
+#include "barramento_falso.h"
+#include "bmp280.h"
+
+// Compensação do BMP280 contra o exemplo do datasheet (BST-BMP280-DS001, 3.12 e 8.2) e
+// contra as fórmulas em ponto flutuante do próprio datasheet numa grade de leituras.
+// Compilado duas vezes: com a fórmula de pressão de 32 bits e com a de 64 bits.
+
+static const struct bmp280_calib_param calib_datasheet = {
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000,
+};
+#define RAW_T_DATASHEET 519888
+#define RAW_P_DATASHEET 415148
+
+// O datasheet dá T = 25,08 °C e p = 100653,27 Pa (em double). As fórmulas inteiras de
+// referência dele chegam a 100656 Pa (32 bits) e 25767233 Pa/256 = 100653,25 Pa (64 bits)
+#define T_DATASHEET 2508
+#define P_DOUBLE_DATASHEET 100653.27
+#define P_DATASHEET_32 100656
+#define P_Q8_DATASHEET_64 25767233u
+
+// Fórmulas em double do datasheet (8.1); devolve T em °C e p em Pa
+static void compensar_double(int32_t raw_t, int32_t raw_p, const struct bmp280_calib_param *c,
+                             double *t, double *p) {
+    double v1 = (raw_t / 16384.0 - c->dig_t1 / 1024.0) * c->dig_t2;
+    double v2 = (raw_t / 131072.0 - c->dig_t1 / 8192.0) * (raw_t / 131072.0 - c->dig_t1 / 8192.0) * c->dig_t3;
+    double t_fine = v1 + v2;
+    *t = t_fine / 5120.0;
+
+    v1 = t_fine / 2.0 - 64000.0;
+    v2 = v1 * v1 * c->dig_p6 / 32768.0;
+    v2 = v2 + v1 * c->dig_p5 * 2.0;
+    v2 = v2 / 4.0 + c->dig_p4 * 65536.0;
+    v1 = (c->dig_p3 * v1 * v1 / 524288.0 + c->dig_p2 * v1) / 524288.0;
+    v1 = (1.0 + v1 / 32768.0) * c->dig_p1;
+    double pr = 1048576.0 - raw_p;
+    pr = (pr - v2 / 4096.0) * 6250.0 / v1;
+    v1 = c->dig_p9 * pr * pr / 2147483648.0;
+    v2 = pr * c->dig_p8 / 32768.0;
+    *p = pr + (v1 + v2 + c->dig_p7) / 16.0;
+}
+
+static void testar_vetor_datasheet(void) {
+    struct bmp280_compensated out;
+    bmp280_compensate(RAW_T_DATASHEET, RAW_P_DATASHEET, &calib_datasheet, &out);
+    VERIFICAR(out.temperature == T_DATASHEET, "T = %d", (int)out.temperature);
+#if BMP280_PRESSURE_64BIT
+    VERIFICAR(out.pressure_q8 == P_Q8_DATASHEET_64, "p_q8 = %u", (unsigned)out.pressure_q8);
+    VERIFICAR(fabs(out.pressure_q8 / 256.0 - P_DOUBLE_DATASHEET) < 0.05, "p = %.3f", out.pressure_q8 / 256.0);
+    VERIFICAR(out.pressure == 100653, "p = %u", (unsigned)out.pressure);
+#else
+    VERIFICAR(out.pressure == P_DATASHEET_32, "p = %u", (unsigned)out.pressure);
+    VERIFICAR(out.pressure_q8 == (uint32_t)P_DATASHEET_32 << 8, "p_q8 = %u", (unsigned)out.pressure_q8);
+#endif
+}
+
+// Varre temperaturas de -40 a 85 °C e pressões de 30 a 110 kPa (a faixa do sensor)
+static void testar_grade(void) {
+    double erro_t = 0, erro_p = 0;
+    uint32_t pontos = 0;
+    for (int32_t raw_t = 380000; raw_t <= 640000; raw_t += 2500) {
+        for (int32_t raw_p = 150000; raw_p <= 750000; raw_p += 2500) {
+            double t, p;
+            compensar_double(raw_t, raw_p, &calib_datasheet, &t, &p);
+            if (t < -40 || t > 85 || p < 30000 || p > 110000) {
+                continue;
+            }
+            struct bmp280_compensated out;
+            bmp280_compensate(raw_t, raw_p, &calib_datasheet, &out);
+            erro_t = fmax(erro_t, fabs(out.temperature / 100.0 - t));
+            erro_p = fmax(erro_p, fabs(out.pressure_q8 / 256.0 - p));
+            pontos++;
+        }
+    }
+    printf("grade: %u pontos, erro max T %.4f C, p %.4f Pa\n", (unsigned)pontos, erro_t, erro_p);
+    VERIFICAR(pontos > 1000, "grade pequena demais: %u", (unsigned)pontos);
+    // T arredondada a 0,01 °C. Os truncamentos da fórmula de 32 bits somam até ~5,6 Pa
+    // nesta calibração; a de 64 bits fica abaixo de 0,3 Pa
+    VERIFICAR(erro_t <= 0.01, "erro T %.4f", erro_t);
+#if BMP280_PRESSURE_64BIT
+    VERIFICAR(erro_p <= 0.3, "erro p %.4f", erro_p);
+#else
+    VERIFICAR(erro_p <= 6.0, "erro p %.4f", erro_p);
+#endif
+}
+
+// BMP280 emulado: chip ID, calibração do datasheet e a leitura bruta do exemplo
+static void preparar_sensor(DispositivoRegistradores *d, uint8_t chip_id) {
+    memset(d, 0, sizeof(*d));
+    d->reg[REG_CHIP_ID] = chip_id;
+    const uint16_t palavras[] = {
+        calib_datasheet.dig_t1, (uint16_t)calib_datasheet.dig_t2, (uint16_t)calib_datasheet.dig_t3,
+        calib_datasheet.dig_p1, (uint16_t)calib_datasheet.dig_p2, (uint16_t)calib_datasheet.dig_p3,
+        (uint16_t)calib_datasheet.dig_p4, (uint16_t)calib_datasheet.dig_p5, (uint16_t)calib_datasheet.dig_p6,
+        (uint16_t)calib_datasheet.dig_p7, (uint16_t)calib_datasheet.dig_p8, (uint16_t)calib_datasheet.dig_p9,
+    };
+    for (int i = 0; i < 12; i++) {
+        d->reg[REG_DIG_T1_LSB + 2 * i] = palavras[i] & 0xFF;
+        d->reg[REG_DIG_T1_LSB + 2 * i + 1] = palavras[i] >> 8;
+    }
+    d->reg[REG_PRESSURE_MSB] = RAW_P_DATASHEET >> 12;
+    d->reg[REG_PRESSURE_LSB] = (RAW_P_DATASHEET >> 4) & 0xFF;
+    d->reg[REG_PRESSURE_XLSB] = (RAW_P_DATASHEET & 0x0F) << 4;
+    d->reg[REG_TEMP_MSB] = RAW_T_DATASHEET >> 12;
+    d->reg[REG_TEMP_LSB] = (RAW_T_DATASHEET >> 4) & 0xFF;
+    d->reg[REG_TEMP_XLSB] = (RAW_T_DATASHEET & 0x0F) << 4;
+}
+
+// Do init à leitura em rajada pelo barramento emulado: o mesmo vetor chega ao fim
+static void testar_driver(void) {
+    static i2c_queue_t fila;
+    static DispositivoRegistradores sensor;
+    bmp280_dev_t dev;
+
+    barramento_falso_zerar();
+    i2c_queue_init_falso(&fila, i2c0);
+    preparar_sensor(&sensor, BMP280_CHIP_ID);
+    barramento_falso_conectar(i2c0, BMP280_I2C_ADDR, dispositivo_registradores, &sensor);
+
+    VERIFICAR(bmp280_init(&dev, &fila, BMP280_I2C_ADDR), "init falhou");
+    VERIFICAR(memcmp(&dev.calib, &calib_datasheet, sizeof(calib_datasheet)) == 0, "calibracao lida errada");
+    VERIFICAR(bmp280_set_profile(&dev, BMP280_PROFILE_STANDARD), "perfil falhou");
+    VERIFICAR((sensor.reg[REG_CTRL_MEAS] & 0x03) == BMP280_MODE_NORMAL, "ctrl_meas = 0x%02x", sensor.reg[REG_CTRL_MEAS]);
+
+    VERIFICAR(bmp280_request_raw(&dev), "rajada recusada");
+    VERIFICAR(bmp280_busy(&dev), "rajada concluiu antes do barramento");
+    while (bmp280_busy(&dev)) {
+        tight_loop_contents();
+    }
+    int32_t raw_t, raw_p;
+    VERIFICAR(bmp280_get_raw(&dev, &raw_t, &raw_p) == BMP280_OK, "leitura bruta falhou");
+    VERIFICAR(raw_t == RAW_T_DATASHEET && raw_p == RAW_P_DATASHEET, "bruto %d %d", (int)raw_t, (int)raw_p);
+
+    // Outro chip no endereço (ex.: BME280, ID 0x60) ou endereço vazio: init recusa
+    preparar_sensor(&sensor, 0x60);
+    VERIFICAR(!bmp280_init(&dev, &fila, BMP280_I2C_ADDR), "aceitou chip ID errado");
+    VERIFICAR(!bmp280_init(&dev, &fila, BMP280_I2C_ADDR_PRIM), "aceitou endereco vazio");
+}
+
+static void bancada(void) {
+    const uint32_t n = 2000000;
+    volatile uint32_t soma = 0;
+    struct bmp280_compensated out;
+    double t, p;
+    double ns_int = BANCADA_NS(n, {
+        bmp280_compensate(RAW_T_DATASHEET + (int32_t)(_i & 1023), RAW_P_DATASHEET - (int32_t)(_i & 1023),
+                          &calib_datasheet, &out);
+        soma += out.pressure_q8;
+    });
+    double ns_double = BANCADA_NS(n, {
+        compensar_double(RAW_T_DATASHEET + (int32_t)(_i & 1023), RAW_P_DATASHEET - (int32_t)(_i & 1023),
+                         &calib_datasheet, &t, &p);
+        soma += (uint32_t)p;
+    });
+    printf("bancada (%s bits): bmp280_compensate %.1f ns/amostra, double do datasheet %.1f ns/amostra\n",
+           BMP280_PRESSURE_64BIT ? "64" : "32", ns_int, ns_double);
+}
+
+int main(void) {
+    testar_vetor_datasheet();
+    testar_grade();
+    testar_driver();
+    bancada();
+    return host_resultado();
+}
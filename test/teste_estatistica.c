@@ -0,0 +1,108 @@
+#include <math.h>
+#include <stdlib.h>
+#include "host.h"
+#include "estatistica.h"
+
+// Filtro de mediana e janelas deslizantes contra um cálculo direto em double
+
+// Compara o resumo com média e desvio em dois passos sobre as amostras filtradas
+static void comparar(const char *nome, const ResumoEstat *s, const int32_t *x, uint32_t n) {
+    double media = 0, m2 = 0;
+    int32_t min = INT32_MAX, max = INT32_MIN;
+    for (uint32_t i = 0; i < n; i++) {
+        media += x[i];
+        if (x[i] < min) min = x[i];
+        if (x[i] > max) max = x[i];
+    }
+    media /= n;
+    for (uint32_t i = 0; i < n; i++) {
+        m2 += (x[i] - media) * (x[i] - media);
+    }
+    double desvio = n > 1 ? sqrt(m2 / (n - 1)) : 0;
+    printf("%s: n=%u media %d (%.2f) desvio %d (%.2f)\n", nome, (unsigned)s->n, (int)s->media, media,
+           (int)s->desvio, desvio);
+    VERIFICAR(s->n == n, "%s: n %u, esperado %u", nome, (unsigned)s->n, (unsigned)n);
+    VERIFICAR(fabs(s->media - media) <= 0.5 + 1e-9, "%s: media %d, esperado %.2f", nome, (int)s->media, media);
+    // Raiz inteira truncada: até 1 abaixo
+    VERIFICAR(s->desvio <= desvio + 1e-9 && s->desvio > desvio - 1, "%s: desvio %d, esperado %.3f", nome,
+              (int)s->desvio, desvio);
+    VERIFICAR(s->min == min && s->max == max, "%s: min/max %d/%d, esperado %d/%d", nome, (int)s->min,
+              (int)s->max, (int)min, (int)max);
+}
+
+static void testar_mediana(void) {
+    CanalEstat c;
+    canal_estat_init(&c, 50);
+    const int32_t brutas[] = {100, 101, 102, 5000, 103, 104, -3000, 105, 106, 107};
+    const int32_t esperadas[] = {100, 101, 101, 102, 102, 103, 103, 104, 104, 105};
+    for (int i = 0; i < 10; i++) {
+        int32_t f = canal_estat_atualizar(&c, brutas[i], (uint32_t)i * 10);
+        VERIFICAR(f == esperadas[i], "amostra %d: %d, esperado %d", i, (int)f, (int)esperadas[i]);
+    }
+    VERIFICAR(c.espurias == 2, "espurias %u", (unsigned)c.espurias);
+}
+
+// Pressão a 100 Hz por 10 min (60000 amostras em torno de 100 kPa): a janela de 10 min
+// precisa do desvio certo mesmo com Σx² na casa de 10^14
+static int32_t filtradas[60000];
+
+static void testar_pressao_100hz(void) {
+    CanalEstat c;
+    canal_estat_init(&c, 200);
+    srand(3);
+    uint32_t n = 0;
+    for (uint32_t t = 0; t < 600000; t += 10) {
+        // Queda lenta de 300 Pa com ruído de ±20 Pa
+        int32_t p = 101000 - (int32_t)(t / 2000) + rand() % 41 - 20;
+        filtradas[n++] = canal_estat_atualizar(&c, p, t);
+    }
+    ResumoEstat r;
+    canal_estat_resumo(&c, JANELA_10MIN, &r);
+    comparar("pressao 10 min", &r, filtradas, n);
+
+    // A de 1 min cobre os 6 blocos de 10 s mais recentes: de 540 s em diante
+    canal_estat_resumo(&c, JANELA_1MIN, &r);
+    comparar("pressao 1 min", &r, filtradas + 54000, n - 54000);
+}
+
+static void testar_janela_tempo(void) {
+    CanalEstat c;
+    canal_estat_init(&c, 1000);
+    // Valores negativos e grandes (altitude em dm abaixo do nível do mar, por exemplo)
+    int32_t x[120];
+    for (uint32_t i = 0; i < 120; i++) {
+        x[i] = canal_estat_atualizar(&c, -20000 + (int32_t)(i % 7) * 3, i * 1000);
+    }
+    ResumoEstat r;
+    canal_estat_resumo(&c, JANELA_10MIN, &r);
+    comparar("negativos", &r, x, 120);
+
+    // Depois de uma pausa maior que a janela, só o que veio depois conta
+    canal_estat_atualizar(&c, -19990, 2000000);
+    canal_estat_resumo(&c, JANELA_10MIN, &r);
+    VERIFICAR(r.n == 1 && r.desvio == 0, "n %u desvio %d depois da pausa", (unsigned)r.n, (int)r.desvio);
+
+    CanalEstat vazio;
+    canal_estat_init(&vazio, 10);
+    canal_estat_resumo(&vazio, JANELA_1MIN, &r);
+    VERIFICAR(r.n == 0 && r.media == 0 && r.desvio == 0, "janela vazia");
+}
+
+static void bancada(void) {
+    CanalEstat c;
+    canal_estat_init(&c, 200);
+    const uint32_t n = 4000000;
+    volatile uint32_t soma = 0;
+    double ns = BANCADA_NS(n, soma += (uint32_t)canal_estat_atualizar(&c, 100000 + (int32_t)(_i & 63), _i * 10));
+    ResumoEstat r;
+    double ns_resumo = BANCADA_NS(100000, canal_estat_resumo(&c, JANELA_10MIN, &r));
+    printf("bancada: canal_estat_atualizar %.1f ns, resumo de 10 min %.1f ns\n", ns, ns_resumo);
+}
+
+int main(void) {
+    testar_mediana();
+    testar_pressao_100hz();
+    testar_janela_tempo();
+    bancada();
+    return host_resultado();
+}
@@ -0,0 +1,361 @@
+#include <string.h>
+#include "host.h"
+#include "barramento_falso.h"
+#include "i2c_queue.h"
+#include "aht20.h"
+
+// Fila I2C sobre o backend falso: ordem, conclusão, callbacks, retentativas, prazo e
+// reserva do barramento, e o driver do AHT20 portado para ela contra um sensor emulado
+
+static i2c_queue_t fila;
+
+// Dispositivo que aceita tudo e devolve o próprio endereço nos bytes lidos
+static i2c_txn_status_t eco(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    memset(rx, (int)(intptr_t)ctx, rx_len);
+    return I2C_TXN_OK;
+}
+
+// Falha as 'n' primeiras transações com o status dado e depois aceita
+typedef struct {
+    uint8_t falhas_restantes;
+    i2c_txn_status_t falha;
+    uint32_t chamadas;
+} Instavel;
+
+static i2c_txn_status_t instavel(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    Instavel *d = ctx;
+    d->chamadas++;
+    if (d->falhas_restantes) {
+        d->falhas_restantes--;
+        return d->falha;
+    }
+    return I2C_TXN_OK;
+}
+
+static uint8_t ordem_callbacks[16];
+static uint8_t num_callbacks;
+
+static void cenario(void) {
+    barramento_falso_zerar();
+    num_callbacks = 0;
+    host_definir_us(10000000);
+    i2c_queue_init_falso(&fila, i2c0);
+}
+
+static void esperar(const i2c_txn_t *txn) {
+    for (int i = 0; i < 100000 && i2c_txn_pending(txn); i++) {
+        i2c_queue_watchdog(&fila);
+        tight_loop_contents();
+    }
+}
+
+static void anotar(i2c_txn_t *txn, void *user) {
+    if (num_callbacks < count_of(ordem_callbacks)) {
+        ordem_callbacks[num_callbacks] = txn->addr;
+    }
+    num_callbacks++;
+}
+
+static void novo(i2c_txn_t *txn, uint8_t addr, uint8_t *rx, uint8_t rx_len) {
+    memset(txn, 0, sizeof(*txn));
+    static const uint8_t reg = 0x00;
+    i2c_txn_setup(txn, addr, &reg, 1, rx, rx_len);
+    txn->callback = anotar;
+}
+
+static void testar_ordem(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    barramento_falso_conectar(i2c0, 0x20, eco, (void *)0x20);
+    barramento_falso_conectar(i2c0, 0x30, eco, (void *)0x30);
+
+    const uint8_t enderecos[] = {0x20, 0x10, 0x30, 0x10, 0x20};
+    i2c_txn_t txn[5];
+    uint8_t rx[5][4];
+    num_callbacks = 0;
+    for (int i = 0; i < 5; i++) {
+        novo(&txn[i], enderecos[i], rx[i], sizeof(rx[i]));
+        VERIFICAR(i2c_queue_submit(&fila, &txn[i]), "submit %d recusado", i);
+    }
+    // Só a primeira foi ao barramento; nada termina sem o tempo do barramento passar
+    VERIFICAR(fila.atual == &txn[0] && fila.count == 4, "atual %p count %u", (void *)fila.atual, fila.count);
+    VERIFICAR(num_callbacks == 0, "callback antes do fim: %u", num_callbacks);
+
+    esperar(&txn[4]);
+    const RegistroBarramento *r = barramento_falso_registro(i2c0);
+    VERIFICAR(r->transacoes == 5, "transacoes %u", (unsigned)r->transacoes);
+    VERIFICAR(num_callbacks == 5, "callbacks %u", num_callbacks);
+    for (int i = 0; i < 5; i++) {
+        VERIFICAR(r->enderecos[i] == enderecos[i], "barramento[%d] = 0x%02x", i, r->enderecos[i]);
+        VERIFICAR(ordem_callbacks[i] == enderecos[i], "callback[%d] = 0x%02x", i, ordem_callbacks[i]);
+        VERIFICAR(txn[i].status == I2C_TXN_OK && txn[i].health.ok == 1, "txn %d status %d", i, txn[i].status);
+        VERIFICAR(rx[i][3] == enderecos[i], "rx %d = 0x%02x", i, rx[i][3]);
+    }
+}
+
+static void testar_limites(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    i2c_txn_t txn[I2C_QUEUE_SIZE + 2];
+    uint8_t rx[I2C_QUEUE_SIZE + 2];
+    // Uma no barramento e I2C_QUEUE_SIZE na fila; a seguinte é recusada
+    for (int i = 0; i < I2C_QUEUE_SIZE + 1; i++) {
+        novo(&txn[i], 0x10, &rx[i], 1);
+        VERIFICAR(i2c_queue_submit(&fila, &txn[i]), "submit %d recusado", i);
+    }
+    novo(&txn[I2C_QUEUE_SIZE + 1], 0x10, &rx[0], 1);
+    VERIFICAR(!i2c_queue_submit(&fila, &txn[I2C_QUEUE_SIZE + 1]), "fila cheia aceitou");
+    VERIFICAR(!i2c_queue_submit(&fila, &txn[1]), "aceitou descritor ja pendente");
+
+    i2c_txn_t grande, vazia;
+    uint8_t buf[I2C_QUEUE_MAX_LEN + 1];
+    novo(&grande, 0x10, buf, I2C_QUEUE_MAX_LEN);
+    VERIFICAR(!i2c_queue_submit(&fila, &grande), "aceitou transacao maior que I2C_QUEUE_MAX_LEN");
+    novo(&vazia, 0x10, NULL, 0);
+    vazia.tx_len = 0;
+    VERIFICAR(!i2c_queue_submit(&fila, &vazia), "aceitou transacao vazia");
+    esperar(&txn[I2C_QUEUE_SIZE]);
+}
+
+static void testar_falhas(void) {
+    cenario();
+    Instavel d = {.falhas_restantes = 1, .falha = I2C_TXN_NACK};
+    barramento_falso_conectar(i2c0, 0x40, instavel, &d);
+    i2c_txn_t txn;
+    uint8_t rx;
+
+    // Endereço vazio: NACK sem retentativas
+    novo(&txn, 0x41, &rx, 1);
+    VERIFICAR(!i2c_queue_transfer(&fila, &txn, 10000), "endereco vazio respondeu");
+    VERIFICAR(txn.status == I2C_TXN_NACK && txn.health.nacks == 1, "status %d nacks %u", txn.status,
+              (unsigned)txn.health.nacks);
+
+    // Um NACK com uma retentativa disponível: conclui OK e gasta o orçamento
+    novo(&txn, 0x40, &rx, 1);
+    txn.retries = 1;
+    VERIFICAR(i2c_queue_transfer(&fila, &txn, 10000), "retentativa nao recuperou");
+    VERIFICAR(txn.health.retries == 1 && txn.health.nacks == 1 && txn.health.ok == 1, "saude %u/%u/%u",
+              (unsigned)txn.health.retries, (unsigned)txn.health.nacks, (unsigned)txn.health.ok);
+    VERIFICAR(fila.retry_budget == I2C_QUEUE_RETRY_BUDGET - 1, "orcamento %u", fila.retry_budget);
+
+    // Orçamento esgotado: as falhas seguintes não se repetem até a recarga (1 s)
+    d.falhas_restantes = 255;
+    for (int i = 0; i < I2C_QUEUE_RETRY_BUDGET + 2; i++) {
+        novo(&txn, 0x40, &rx, 1);
+        txn.retries = 1;
+        i2c_queue_transfer(&fila, &txn, 10000);
+    }
+    VERIFICAR(fila.retry_budget == 0, "orcamento %u", fila.retry_budget);
+    uint32_t antes = d.chamadas;
+    novo(&txn, 0x40, &rx, 1);
+    txn.retries = 1;
+    i2c_queue_transfer(&fila, &txn, 10000);
+    VERIFICAR(d.chamadas == antes + 1 && txn.health.retries == 0, "repetiu sem orcamento");
+    host_avancar_us(1000000);
+    i2c_queue_watchdog(&fila);
+    VERIFICAR(fila.retry_budget == I2C_QUEUE_RETRY_BUDGET, "orcamento nao recarregou: %u", fila.retry_budget);
+}
+
+static void testar_prazo(void) {
+    cenario();
+    Instavel travado = {.falhas_restantes = 1, .falha = I2C_TXN_TIMEOUT};
+    barramento_falso_conectar(i2c0, 0x50, instavel, &travado);
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    i2c_txn_t a, b;
+    uint8_t rx_a, rx_b;
+    novo(&a, 0x50, &rx_a, 1);
+    novo(&b, 0x10, &rx_b, 1);
+    i2c_queue_submit(&fila, &a);
+    i2c_queue_submit(&fila, &b);
+
+    // Antes do prazo o watchdog não interfere
+    host_avancar_us(I2C_QUEUE_DEADLINE_US / 2);
+    VERIFICAR(!i2c_queue_watchdog(&fila) && i2c_txn_pending(&a), "abortou antes do prazo");
+
+    // Escravo segurando o barramento: abort, bus clear, TIMEOUT e a fila segue
+    esperar(&b);
+    const RegistroBarramento *r = barramento_falso_registro(i2c0);
+    VERIFICAR(a.status == I2C_TXN_TIMEOUT && a.health.timeouts == 1, "status %d", a.status);
+    VERIFICAR(r->abortos == 1 && r->recuperacoes == 1 && fila.recoveries == 1, "abortos %u recuperacoes %u",
+              (unsigned)r->abortos, (unsigned)r->recuperacoes);
+    VERIFICAR(b.status == I2C_TXN_OK, "seguinte %d", b.status);
+}
+
+static void irq_conclui_transacao(void) {
+    host_avancar_us(5);
+}
+
+// A IRQ de fim de transação chega entre a chamada do watchdog e a seção crítica e já
+// inicia a seguinte: o prazo da nova não pode sair vencido
+static void testar_prazo_corrida(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    barramento_falso_conectar(i2c0, 0x20, eco, (void *)0x20);
+    i2c_txn_t a, b;
+    uint8_t rx_a, rx_b;
+    novo(&a, 0x10, &rx_a, 1);
+    novo(&b, 0x20, &rx_b, 1);
+    uint64_t inicio = time_us_64();
+    i2c_queue_submit(&fila, &a);
+    i2c_queue_submit(&fila, &b);
+
+    // a termina em (1 + 2 bytes) * 23 us; o relógio para 1 us antes disso
+    host_definir_us(inicio + 3 * 23 - 1);
+    host_irq_pendente = irq_conclui_transacao;
+    VERIFICAR(!i2c_queue_watchdog(&fila), "watchdog abortou a transação recém-iniciada");
+    VERIFICAR(a.status == I2C_TXN_OK && i2c_txn_pending(&b), "a %d, b pendente %d", a.status, i2c_txn_pending(&b));
+    esperar(&b);
+    const RegistroBarramento *r = barramento_falso_registro(i2c0);
+    VERIFICAR(b.status == I2C_TXN_OK && r->abortos == 0, "b %d, abortos %u", b.status, (unsigned)r->abortos);
+}
+
+// Um callback pode enfileirar a próxima etapa do mesmo dispositivo
+static i2c_txn_t etapa;
+static uint8_t etapas;
+
+static void encadear(i2c_txn_t *txn, void *user) {
+    static uint8_t rx;
+    if (++etapas < 3) {
+        i2c_txn_setup(txn, txn->addr, NULL, 0, &rx, 1);
+        VERIFICAR(i2c_queue_submit(&fila, txn), "etapa %u recusada no callback", etapas);
+    }
+}
+
+static void testar_encadeamento(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    static uint8_t rx;
+    memset(&etapa, 0, sizeof(etapa));
+    i2c_txn_setup(&etapa, 0x10, NULL, 0, &rx, 1);
+    etapa.callback = encadear;
+    etapas = 0;
+    i2c_queue_submit(&fila, &etapa);
+    for (int i = 0; i < 1000 && etapas < 3; i++) {
+        tight_loop_contents();
+    }
+    VERIFICAR(etapas == 3 && barramento_falso_registro(i2c0)->transacoes == 3, "etapas %u", etapas);
+}
+
+static void testar_reserva(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x10, eco, (void *)0x10);
+    i2c_txn_t a, b;
+    uint8_t rx_a, rx_b;
+    novo(&a, 0x10, &rx_a, 1);
+    novo(&b, 0x10, &rx_b, 1);
+    i2c_queue_submit(&fila, &a);
+
+    // A reserva espera a transação em curso; a enfileirada depois fica parada até o release
+    VERIFICAR(i2c_queue_acquire(&fila, 10000), "reserva falhou");
+    VERIFICAR(a.status == I2C_TXN_OK, "reserva nao esperou a atual");
+    i2c_queue_submit(&fila, &b);
+    host_avancar_us(5000);
+    VERIFICAR(i2c_txn_pending(&b) && !fila.atual, "transacao comecou com o barramento reservado");
+    i2c_queue_release(&fila);
+    esperar(&b);
+    VERIFICAR(b.status == I2C_TXN_OK, "status %d depois do release", b.status);
+}
+
+// Fluxo pré-montado: cada trecho entre repeated starts chega separado ao dispositivo
+static uint8_t trechos[4][4];
+static size_t tam_trechos[4];
+static uint8_t num_trechos;
+
+static i2c_txn_status_t gravar_trechos(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    memcpy(trechos[num_trechos], tx, tx_len);
+    tam_trechos[num_trechos++] = tx_len;
+    return I2C_TXN_OK;
+}
+
+static void testar_fluxo(void) {
+    cenario();
+    barramento_falso_conectar(i2c0, 0x3C, gravar_trechos, NULL);
+    const uint16_t fluxo[] = {0x00, 0x21, 0x40 | I2C_IC_DATA_CMD_RESTART_BITS, 0xAA, 0x55 | I2C_IC_DATA_CMD_STOP_BITS};
+    i2c_txn_t txn = {0};
+    i2c_txn_setup_stream(&txn, 0x3C, fluxo, 5);
+    num_trechos = 0;
+    VERIFICAR(i2c_queue_submit(&fila, &txn), "fluxo recusado");
+    esperar(&txn);
+    VERIFICAR(txn.status == I2C_TXN_OK && num_trechos == 2, "status %d trechos %u", txn.status, num_trechos);
+    VERIFICAR(tam_trechos[0] == 2 && trechos[0][1] == 0x21, "trecho 0");
+    VERIFICAR(tam_trechos[1] == 3 && trechos[1][0] == 0x40 && trechos[1][2] == 0x55, "trecho 1");
+}
+
+// AHT20 emulado: conversão de 80 ms depois do disparo, dados com CRC
+typedef struct {
+    uint64_t pronto_us;
+    uint32_t umidade, temperatura;  // brutos de 20 bits
+    bool calibrado;
+} Aht20Falso;
+
+static uint8_t crc8(const uint8_t *d, int n) {
+    uint8_t crc = 0xFF;
+    for (int i = 0; i < n; i++) {
+        crc ^= d[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static i2c_txn_status_t aht20_falso(void *ctx, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    Aht20Falso *s = ctx;
+    if (tx_len && tx[0] == AHT20_CMD_INIT) {
+        s->calibrado = true;
+    } else if (tx_len && tx[0] == AHT20_CMD_TRIGGER) {
+        s->pronto_us = time_us_64() + 80000;
+    }
+    if (rx_len) {
+        uint8_t b[7];
+        b[0] = (s->calibrado ? 0x08 : 0) | (time_us_64() < s->pronto_us ? 0x80 : 0);
+        b[1] = s->umidade >> 12;
+        b[2] = s->umidade >> 4;
+        b[3] = (uint8_t)((s->umidade & 0x0F) << 4) | (s->temperatura >> 16);
+        b[4] = s->temperatura >> 8;
+        b[5] = s->temperatura;
+        b[6] = crc8(b, 6);
+        memcpy(rx, b, rx_len < 7 ? rx_len : 7);
+    }
+    return I2C_TXN_OK;
+}
+
+static void testar_aht20(void) {
+    cenario();
+    // 45,00 %RH e 23,50 °C
+    Aht20Falso sensor = {.umidade = 471859, .temperatura = 385352};
+    barramento_falso_conectar(i2c0, AHT20_I2C_ADDR, aht20_falso, &sensor);
+    AHT20_Dev dev;
+    AHT20_Data dados;
+    VERIFICAR(aht20_init(&dev, &fila), "init falhou");
+
+    VERIFICAR(aht20_trigger(&dev), "disparo recusado");
+    esperar(&dev.txn);
+    aht20_poll(&dev);
+    esperar(&dev.txn);
+    VERIFICAR(aht20_result(&dev, &dados) == AHT20_BUSY, "conversao de 80 ms terminou na hora");
+
+    host_avancar_us(80000);
+    aht20_poll(&dev);
+    esperar(&dev.txn);
+    VERIFICAR(aht20_result(&dev, &dados) == AHT20_OK, "leitura falhou");
+    VERIFICAR(dados.humidity == 4500 && dados.temperature == 2350, "UR %d T %d", (int)dados.humidity,
+              (int)dados.temperature);
+
+    // CRC errado é recusado
+    dev.buf[6] ^= 1;
+    VERIFICAR(aht20_result(&dev, &dados) == AHT20_ERROR, "aceitou CRC errado");
+}
+
+int main(void) {
+    testar_ordem();
+    testar_limites();
+    testar_falhas();
+    testar_prazo();
+    testar_prazo_corrida();
+    testar_encadeamento();
+    testar_reserva();
+    testar_fluxo();
+    testar_aht20();
+    return host_resultado();
+}
@@ -0,0 +1,126 @@
+#include <string.h>
+#include "host.h"
+#include "metricas.h"
+
+// Histogramas e texto de exposição do Prometheus: baldes nos limites, formato exato,
+// decimais sem ponto flutuante e buffer cheio sem escrever além dele
+
+static void testar_baldes(void) {
+    Histograma h = {0};
+    for (int i = 0; i < METRICAS_NUM_LIMITES; i++) {
+        histograma_registrar(&h, metricas_limites_us[i]);      // no limite: fica no balde
+        histograma_registrar(&h, metricas_limites_us[i] + 1);  // acima: vai para o próximo
+    }
+    histograma_registrar(&h, 0);
+    histograma_registrar(&h, UINT32_MAX);
+
+    VERIFICAR(h.baldes[0] == 2, "balde 0 com %u", (unsigned)h.baldes[0]);
+    for (int i = 1; i < METRICAS_NUM_LIMITES; i++) {
+        VERIFICAR(h.baldes[i] == 2, "balde %d com %u", i, (unsigned)h.baldes[i]);
+    }
+    VERIFICAR(h.baldes[METRICAS_NUM_LIMITES] == 2, "+Inf com %u", (unsigned)h.baldes[METRICAS_NUM_LIMITES]);
+
+    // A soma de 64 bits não estoura com durações grandes
+    uint64_t esperado = 2ull * UINT32_MAX;
+    Histograma g = {0};
+    histograma_registrar(&g, UINT32_MAX);
+    histograma_registrar(&g, UINT32_MAX);
+    VERIFICAR(g.soma_us == esperado, "soma %llu", (unsigned long long)g.soma_us);
+}
+
+static void testar_formato(void) {
+    Histograma h = {0};
+    histograma_registrar(&h, 40);
+    histograma_registrar(&h, 300);
+    histograma_registrar(&h, 300);
+    histograma_registrar(&h, 250000);
+    char buf[1024];
+    int len = metricas_histograma(buf, sizeof(buf), "t_segundos", "tarefa=\"leds\"", &h);
+    const char *esperado =
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.00005\"} 1\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.00025\"} 1\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.001\"} 3\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.005\"} 3\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.02\"} 3\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"0.1\"} 3\n"
+        "t_segundos_bucket{tarefa=\"leds\",le=\"+Inf\"} 4\n"
+        "t_segundos_sum{tarefa=\"leds\"} 0.25064\n"
+        "t_segundos_count{tarefa=\"leds\"} 4\n";
+    VERIFICAR(strcmp(buf, esperado) == 0, "histograma:\n%s", buf);
+    VERIFICAR(len == (int)strlen(esperado), "retornou %d, escreveu %zu", len, strlen(buf));
+
+    // Sem rótulos não sobram chaves vazias
+    len = metricas_histograma(buf, sizeof(buf), "x", NULL, &h);
+    VERIFICAR(strstr(buf, "x_bucket{le=\"+Inf\"} 4\n") && strstr(buf, "x_sum 0.25064\n") &&
+                  strstr(buf, "x_count 4\n"),
+              "histograma sem rótulos:\n%s", buf);
+
+    metricas_cabecalho(buf, sizeof(buf), "x", "counter", "Ajuda");
+    VERIFICAR(strcmp(buf, "# HELP x Ajuda\n# TYPE x counter\n") == 0, "cabeçalho: %s", buf);
+}
+
+static void testar_fixo(void) {
+    static const struct {
+        uint64_t valor;
+        uint8_t casas;
+        const char *texto;
+    } casos[] = {
+        {873, 3, "r 0.873\n"},   {1000, 3, "r 1\n"},        {1500, 3, "r 1.5\n"},
+        {250, 6, "r 0.00025\n"}, {0, 6, "r 0\n"},           {7, 0, "r 7\n"},
+        {UINT64_MAX, 0, "r 18446744073709551615\n"},         {4000000000123ull, 3, "r 4000000000.123\n"},
+    };
+    char buf[64];
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        metricas_valor_fixo(buf, sizeof(buf), "r", NULL, casos[i].valor, casos[i].casas);
+        VERIFICAR(strcmp(buf, casos[i].texto) == 0, "%llu com %u casas: %s", (unsigned long long)casos[i].valor,
+                  casos[i].casas, buf);
+    }
+}
+
+// Escritas encadeadas como no /metrics: com o buffer acabando, cada escritor devolve no
+// máximo o que coube e os seguintes não passam do fim
+static void testar_buffer_cheio(void) {
+    Histograma h = {0};
+    for (int i = 0; i < METRICAS_NUM_BALDES; i++) h.baldes[i] = UINT32_MAX / METRICAS_NUM_BALDES;
+    h.soma_us = UINT64_MAX;
+
+    char completo[2048];
+    int total = 0;
+    total += metricas_cabecalho(completo + total, sizeof(completo) - total, "m", "histogram", "Ajuda");
+    total += metricas_histograma(completo + total, sizeof(completo) - total, "m", "a=\"b\"", &h);
+    total += metricas_valor(completo + total, sizeof(completo) - total, "v", NULL, UINT32_MAX);
+
+    for (size_t tam = 1; tam <= (size_t)total + 2; tam++) {
+        char buf[2048 + 16];
+        memset(buf, 0x55, sizeof(buf));
+        int len = 0;
+        len += metricas_cabecalho(buf + len, tam - len, "m", "histogram", "Ajuda");
+        len += metricas_histograma(buf + len, tam - len, "m", "a=\"b\"", &h);
+        len += metricas_valor(buf + len, tam - len, "v", NULL, UINT32_MAX);
+
+        bool intocado = true;
+        for (size_t i = tam; i < sizeof(buf); i++) intocado &= buf[i] == 0x55;
+        size_t esperado = tam - 1 < (size_t)total ? tam - 1 : (size_t)total;
+        VERIFICAR(intocado, "tam %zu: escreveu além do buffer", tam);
+        VERIFICAR((size_t)len == esperado, "tam %zu: retornou %d, esperado %zu", tam, len, esperado);
+        VERIFICAR(memcmp(buf, completo, esperado) == 0, "tam %zu: prefixo diferente", tam);
+    }
+}
+
+static void bancada(void) {
+    Histograma h = {0};
+    char buf[1024];
+    double registrar = BANCADA_NS(1000000, histograma_registrar(&h, (_i * 2654435761u) % 200000));
+    double escrever = BANCADA_NS(20000, metricas_histograma(buf, sizeof(buf), "estacao_tarefa_segundos",
+                                                            "tarefa=\"amostragem\"", &h));
+    printf("bancada (host): registrar %.1f ns, escrever um histograma %.0f ns\n", registrar, escrever);
+}
+
+int main(void) {
+    testar_baldes();
+    testar_formato();
+    testar_fixo();
+    testar_buffer_cheio();
+    bancada();
+    return host_resultado();
+}
@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "ponto_fixo.h"
+
+// Formatação e interpretação de inteiros com casas decimais implícitas
+
+static void formatar(int32_t valor, uint8_t casas_valor, uint8_t casas_saida, const char *esperado) {
+    char buf[24];
+    int n = fixo_formatar(buf, sizeof(buf), valor, casas_valor, casas_saida);
+    VERIFICAR(strcmp(buf, esperado) == 0 && n == (int)strlen(esperado), "%d (%u->%u casas) = \"%s\", esperado \"%s\"",
+              (int)valor, casas_valor, casas_saida, buf, esperado);
+}
+
+static void interpretar(const char *texto, uint8_t casas, bool ok, int32_t esperado) {
+    int32_t v = 12345;
+    bool r = fixo_interpretar(texto, casas, &v);
+    VERIFICAR(r == ok && (!ok || v == esperado), "\"%s\" (%u casas) = %d/%d, esperado %d/%d", texto, casas, r,
+              (int)v, ok, (int)esperado);
+}
+
+static void testar_formatar(void) {
+    formatar(2537, 2, 2, "25.37");
+    formatar(2537, 2, 1, "25.4");       // metade se afasta do zero
+    formatar(2549, 2, 1, "25.5");
+    formatar(-5, 2, 1, "-0.1");
+    formatar(-4, 2, 1, "0.0");          // sem "-0.0"
+    formatar(-2999, 2, 1, "-30.0");
+    formatar(0, 2, 2, "0.00");
+    formatar(100653, 3, 1, "100.7");    // Pa -> kPa
+    formatar(1235, 1, 0, "124");        // dm -> m
+    formatar(7, 2, 3, "0.07");          // casas_saida limitada a casas_valor
+    formatar(INT32_MIN, 2, 2, "-21474836.48");
+    formatar(INT32_MAX, 0, 0, "2147483647");
+
+    // Buffer curto: trunca e retorna o tamanho que teria, como o snprintf
+    char curto[4];
+    int n = fixo_formatar(curto, sizeof(curto), 2537, 2, 2);
+    VERIFICAR(n == 5 && strcmp(curto, "25.") == 0, "%d \"%s\"", n, curto);
+}
+
+static void testar_interpretar(void) {
+    interpretar("-1.25", 2, true, -125);
+    interpretar("3", 2, true, 300);
+    interpretar("+0.5", 2, true, 50);
+    interpretar(".5", 2, true, 50);
+    interpretar("1.235&x", 2, true, 124);   // para no '&', arredonda pelo primeiro excedente
+    interpretar("12.3449", 2, true, 1234);
+    interpretar("-0.004", 2, true, 0);
+    interpretar("101800", 0, true, 101800);
+    interpretar("12.7", 0, true, 13);
+    interpretar("abc", 2, false, 0);
+    interpretar("-", 2, false, 0);
+    interpretar("", 2, false, 0);
+    interpretar("21474836.47", 2, true, INT32_MAX);
+    interpretar("21474836.48", 2, false, 0);
+    interpretar("99999999999", 0, false, 0);
+}
+
+// Formatar e interpretar de volta com as mesmas casas devolve o valor original
+static void testar_ida_e_volta(void) {
+    srand(7);
+    for (int i = 0; i < 200000; i++) {
+        int32_t v = (int32_t)(((uint32_t)rand() << 16) ^ (uint32_t)rand());
+        uint8_t casas = (uint8_t)(rand() % 4);
+        char buf[24];
+        int32_t volta;
+        fixo_formatar(buf, sizeof(buf), v, casas, casas);
+        if (!fixo_interpretar(buf, casas, &volta) || volta != v) {
+            VERIFICAR(false, "%d com %u casas -> \"%s\" -> %d", (int)v, casas, buf, (int)volta);
+            break;
+        }
+    }
+}
+
+int main(void) {
+    testar_formatar();
+    testar_interpretar();
+    testar_ida_e_volta();
+    return host_resultado();
+}
@@ -0,0 +1,153 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "simulador.h"
+#include "estatistica.h"
+
+// Modelo de clima sintético: reprodutível pela semente, com ciclo diurno, frentes,
+// perdas e picos nas proporções do perfil
+
+// Instante real (ms) em que o perfil chega à hora simulada h
+static uint32_t hora(const PerfilClima *p, uint32_t h) {
+    return (uint32_t)((uint64_t)h * 3600 * 1000 / p->aceleracao);
+}
+
+static void testar_reprodutivel(void) {
+    Simulador a, b, c;
+    simulador_init(&a, &PERFIL_ESTRESSE, 42);
+    simulador_init(&b, &PERFIL_ESTRESSE, 42);
+    simulador_init(&c, &PERFIL_ESTRESSE, 43);
+    uint32_t diferentes = 0;
+    for (uint32_t t = 0; t < 100000; t += 10) {
+        EstadoClima ea, eb, ec;
+        memset(&ea, 0, sizeof(ea));
+        memset(&eb, 0, sizeof(eb));
+        memset(&ec, 0, sizeof(ec));
+        bool oka = simulador_medir(&a, t, &ea);
+        bool okb = simulador_medir(&b, t, &eb);
+        simulador_medir(&c, t, &ec);
+        VERIFICAR(oka == okb && memcmp(&ea, &eb, sizeof(ea)) == 0, "semente 42 divergiu em t=%u", (unsigned)t);
+        if (memcmp(&ea, &ec, sizeof(ea)) != 0) diferentes++;
+    }
+    VERIFICAR(diferentes > 9000, "semente 43 igual à 42 em %u de 10000", 10000 - (unsigned)diferentes);
+
+    // Semente zero não trava o xorshift
+    Simulador z;
+    simulador_init(&z, &PERFIL_ESTAVEL, 0);
+    EstadoClima e1, e2;
+    simulador_medir(&z, 0, &e1);
+    uint32_t iguais = 0;
+    for (int i = 0; i < 100; i++) {
+        simulador_medir(&z, 0, &e2);
+        if (memcmp(&e1, &e2, sizeof(e1)) == 0) iguais++;
+    }
+    VERIFICAR(iguais < 50, "semente zero: %u leituras iguais", (unsigned)iguais);
+}
+
+static void testar_diurno(void) {
+    const PerfilClima *p = &PERFIL_DIURNO;
+    Simulador s;
+    simulador_init(&s, p, 1);
+    EstadoClima e;
+    int32_t tmin = INT32_MAX, tmax = INT32_MIN;
+    uint32_t hmin = 0, hmax = 0;
+    for (uint32_t h = 0; h < 24; h++) {
+        simulador_clima(&s, hora(p, h), &e);
+        if (e.temperatura < tmin) { tmin = e.temperatura; hmin = h; }
+        if (e.temperatura > tmax) { tmax = e.temperatura; hmax = h; }
+    }
+    VERIFICAR(hmax == 15 && hmin == 3, "máxima às %u h e mínima às %u h", (unsigned)hmax, (unsigned)hmin);
+    // Seno de Bhaskara: erro abaixo de 0,2 % da amplitude
+    VERIFICAR(abs(tmax - (p->temp_media + p->temp_amplitude)) <= 2, "máxima %d", (int)tmax);
+    VERIFICAR(abs(tmin - (p->temp_media - p->temp_amplitude)) <= 2, "mínima %d", (int)tmin);
+
+    // Umidade em oposição de fase e maré com dois ciclos por dia
+    simulador_clima(&s, hora(p, 15), &e);
+    VERIFICAR(abs(e.umidade - (p->umid_media - p->umid_amplitude)) <= 4, "umidade às 15 h: %d", (int)e.umidade);
+    double erro_max = 0;
+    for (uint32_t m = 0; m < 24 * 60; m++) {
+        simulador_clima(&s, hora(p, 0) + (uint32_t)((uint64_t)m * 60000 / p->aceleracao), &e);
+        double fase = 2 * M_PI * (m / 60.0 - 9) / 24;
+        double esperado = p->temp_media + p->temp_amplitude * sin(fase);
+        erro_max = fmax(erro_max, fabs(e.temperatura - esperado));
+    }
+    printf("diurno: erro máximo do seno %.2f (0.01 °C) em amplitude %d\n", erro_max, (int)p->temp_amplitude);
+    VERIFICAR(erro_max <= p->temp_amplitude * 0.002 + 1, "erro do seno %.2f", erro_max);
+}
+
+static void testar_frente(void) {
+    const PerfilClima *p = &PERFIL_FRENTE_FRIA;
+    Simulador s;
+    simulador_init(&s, p, 1);
+    EstadoClima fora, auge;
+    Simulador sem = s;
+    PerfilClima sem_frente = *p;
+    sem_frente.frente_periodo_s = 0;
+    sem.perfil = &sem_frente;
+
+    // Auge da primeira frente: 1 h dentro de cada período de 6 h
+    uint32_t t = hora(p, 1);
+    simulador_clima(&s, t, &auge);
+    simulador_clima(&sem, t, &fora);
+    VERIFICAR(fora.pressao - auge.pressao == p->frente_queda_pa, "queda de pressão %d",
+              (int)(fora.pressao - auge.pressao));
+    VERIFICAR(fora.temperatura - auge.temperatura == p->frente_queda_temp, "queda de temperatura %d",
+              (int)(fora.temperatura - auge.temperatura));
+    VERIFICAR(auge.umidade - fora.umidade == p->frente_alta_umid, "alta de umidade %d",
+              (int)(auge.umidade - fora.umidade));
+
+    // Fora da frente o modelo é o mesmo
+    t = hora(p, 4);
+    simulador_clima(&s, t, &auge);
+    simulador_clima(&sem, t, &fora);
+    VERIFICAR(memcmp(&auge, &fora, sizeof(auge)) == 0, "frente ativa fora da janela");
+}
+
+static void testar_falhas_e_picos(void) {
+    const PerfilClima *p = &PERFIL_ESTRESSE;
+    Simulador s;
+    simulador_init(&s, p, 7);
+    CanalEstat canal;
+    canal_estat_init(&canal, 2000);
+    const uint32_t n = 200000;
+    uint32_t perdidas = 0, picos = 0, ruido_fora = 0;
+    int32_t ultima = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t t = i * 10;
+        EstadoClima e, modelo;
+        if (!simulador_medir(&s, t, &e)) {
+            perdidas++;
+            continue;
+        }
+        simulador_clima(&s, t, &modelo);
+        int32_t dp = e.pressao - modelo.pressao;
+        int32_t dt = e.temperatura - modelo.temperatura;
+        if (dp < -10000 || dt > 2500 || (e.umidade == 0 && modelo.umidade > 1000)) {
+            picos++;
+        } else if (abs(dp) > p->ruido_pressao || abs(dt) > p->ruido_temp) {
+            ruido_fora++;
+        }
+        ultima = canal_estat_atualizar(&canal, e.pressao, t);
+        // A 600x a frente derruba até ~80 Pa por amostra e a mediana atrasa duas amostras;
+        // o que importa é que o pico de 20 kPa não passe
+        int32_t desvio = ultima - modelo.pressao;
+        VERIFICAR(abs(desvio) <= 1000, "mediana deixou passar %d Pa em t=%u", (int)desvio, (unsigned)t);
+    }
+    double taxa_perda = 1000.0 * perdidas / n;
+    double taxa_pico = 1000.0 * picos / (n - perdidas);
+    printf("estresse: perdas %.1f/1000 (perfil %u), picos %.1f/1000 (perfil %u, 1/3 a cada canal)\n",
+           taxa_perda, p->falha_permil, taxa_pico, p->pico_permil);
+    VERIFICAR(fabs(taxa_perda - p->falha_permil) < 3, "taxa de perdas %.1f", taxa_perda);
+    VERIFICAR(fabs(taxa_pico - p->pico_permil) < 2, "taxa de picos %.1f", taxa_pico);
+    VERIFICAR(ruido_fora == 0, "%u leituras com ruído acima do pico do perfil", (unsigned)ruido_fora);
+    VERIFICAR(canal.espurias > 0, "nenhum pico rejeitado");
+}
+
+int main(void) {
+    testar_reprodutivel();
+    testar_diurno();
+    testar_frente();
+    testar_falhas_e_picos();
+    return host_resultado();
+}
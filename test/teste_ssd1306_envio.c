@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "oled_falso.h"
+#include "ssd1306.h"
+
+// Atualização parcial do SSD1306 contra o painel emulado: depois de cada envio bem-
+// sucedido a GDDRAM é igual ao quadro desenhado, pelas escritas bloqueantes e pela fila
+
+#define ENDERECO 0x3C
+
+static OledFalso oled;
+static ssd1306_t ssd;
+static i2c_queue_t fila;
+
+static void montar(bool com_fila) {
+    barramento_falso_zerar();
+    host_definir_us(1000000);
+    oled_falso_init(&oled);
+    barramento_falso_conectar(i2c1, ENDERECO, oled_falso_dispositivo, &oled);
+    ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+    ssd1306_config(&ssd);
+    if (com_fila) {
+        i2c_queue_init_falso(&fila, i2c1);
+        ssd1306_attach_queue(&ssd, &fila);
+    }
+}
+
+// Envio completo: no modo fila espera o quadro chegar (o watchdog cuida das falhas)
+static bool enviar(void) {
+    bool ok = ssd1306_send_data(&ssd);
+    for (int i = 0; ssd.queue && i < 100000 && ssd1306_busy(&ssd); i++) {
+        i2c_queue_watchdog(&fila);
+        tight_loop_contents();
+    }
+    return ok && !(ssd.queue && ssd.tx_failed);
+}
+
+// Tela de sensores: temperatura com um dígito decimal e umidade
+static void tela(int valor, int umidade) {
+    char txt[24];
+    ssd1306_fill(&ssd, false);
+    ssd1306_rect(&ssd, 3, 3, 122, 60, true, false);
+    snprintf(txt, sizeof(txt), "T %d.%d C", valor / 10, valor % 10);
+    ssd1306_draw_string(&ssd, txt, 8, 10);
+    snprintf(txt, sizeof(txt), "U %d%%", umidade);
+    ssd1306_draw_string(&ssd, txt, 8, 30);
+}
+
+static void testar_coerencia(bool com_fila, uint16_t falha_permil) {
+    const char *nome = com_fila ? "fila" : "bloqueante";
+    montar(com_fila);
+    oled.falha_permil = falha_permil;
+    srand(5);
+    uint32_t divergentes = 0, enviados = 0;
+    for (int it = 0; it < 5000; it++) {
+        if (it % 3 == 0) {
+            tela(200 + it / 7, 40 + it / 50 % 20);
+        } else {
+            ssd1306_fill_rect(&ssd, rand() % 140 - 6, rand() % 70 - 3, rand() % 20, rand() % 12, rand() & 1);
+            ssd1306_pixel(&ssd, rand() % 128, rand() % 64, rand() & 1);
+            if (it % 11 == 0) ssd1306_scroll_left(&ssd, 0, 127, 2, 6, 1 + rand() % 3);
+        }
+        if (enviar()) {
+            enviados++;
+            if (oled_falso_comparar(&oled, ssd.ram_buffer + 1, 128, 8)) divergentes++;
+        }
+    }
+    // Sem falhas pendentes, o próximo envio sempre deixa o painel em dia
+    oled.falha_permil = 0;
+    enviar();
+    enviar();
+    uint32_t final = oled_falso_comparar(&oled, ssd.ram_buffer + 1, 128, 8);
+    printf("%s, falhas %u/1000: %u envios ok, %u falhas injetadas, %u bytes de imagem\n", nome, falha_permil,
+           (unsigned)enviados, (unsigned)oled.falhas, (unsigned)oled.bytes_dados);
+    VERIFICAR(divergentes == 0, "%s: %u envios ok com a GDDRAM divergente", nome, (unsigned)divergentes);
+    VERIFICAR(final == 0, "%s: %u bytes divergentes no fim", nome, (unsigned)final);
+    VERIFICAR(falha_permil == 0 || oled.falhas > 0, "%s: nenhuma falha injetada", nome);
+}
+
+// Bytes no barramento proporcionais ao que mudou
+static void testar_custo(bool com_fila) {
+    const char *nome = com_fila ? "fila" : "bloqueante";
+    montar(com_fila);
+    const RegistroBarramento *r = barramento_falso_registro(i2c1);
+
+    tela(234, 45);
+    uint32_t b0 = r->bytes, d0 = oled.bytes_dados;
+    enviar();
+    uint32_t quadro = r->bytes - b0, quadro_dados = oled.bytes_dados - d0;
+
+    tela(235, 45);  // um dígito
+    b0 = r->bytes;
+    d0 = oled.bytes_dados;
+    enviar();
+    uint32_t digito = r->bytes - b0, digito_dados = oled.bytes_dados - d0;
+
+    tela(235, 45);  // redesenhado igual
+    b0 = r->bytes;
+    uint32_t t0 = r->transacoes;
+    enviar();
+    uint32_t igual = r->bytes - b0, igual_txn = r->transacoes - t0;
+
+    printf("%s: quadro inteiro %u bytes (%u de imagem), um dígito %u (%u), sem mudança %u\n", nome,
+           (unsigned)quadro, (unsigned)quadro_dados, (unsigned)digito, (unsigned)digito_dados, (unsigned)igual);
+    VERIFICAR(quadro_dados == 1024, "%s: primeiro quadro com %u bytes de imagem", nome, (unsigned)quadro_dados);
+    // Um glifo de 8 colunas; em y = 10 ele ocupa duas páginas
+    VERIFICAR(digito_dados <= 16 && digito <= 16 + 2 * SSD1306_WINDOW_OVERHEAD, "%s: um dígito custou %u bytes",
+              nome, (unsigned)digito);
+    VERIFICAR(igual == 0 && igual_txn == 0, "%s: quadro igual foi ao barramento (%u bytes)", nome, (unsigned)igual);
+}
+
+int main(void) {
+    testar_coerencia(false, 0);
+    testar_coerencia(false, 20);
+    testar_coerencia(true, 0);
+    testar_coerencia(true, 20);
+    testar_custo(false);
+    testar_custo(true);
+    return host_resultado();
+}
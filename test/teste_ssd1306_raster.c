@@ -0,0 +1,204 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "ssd1306.h"
+#include "font.h"
+
+// Primitivas por página do SSD1306 contra a implementação anterior, pixel a pixel,
+// e a bancada do ganho
+
+// --- Referência: o raster antigo, um ssd1306_pixel por ponto ---
+
+static void ref_pixel(ssd1306_t *s, int x, int y, bool v) {
+    if (x < 0 || y < 0 || x >= s->width || y >= s->height) return;
+    uint8_t *b = &s->ram_buffer[1 + x * s->pages + (y >> 3)];
+    if (v) *b |= 1u << (y & 7);
+    else *b &= ~(1u << (y & 7));
+}
+
+static void ref_fill_rect(ssd1306_t *s, int x, int y, int w, int h, bool v) {
+    for (int i = x; i < x + w; i++)
+        for (int j = y; j < y + h; j++) ref_pixel(s, i, j, v);
+}
+
+static void ref_rect(ssd1306_t *s, uint8_t top, uint8_t left, uint8_t w, uint8_t h, bool v, bool fill) {
+    for (int x = left; x < left + w; ++x) {
+        ref_pixel(s, x, top, v);
+        ref_pixel(s, x, top + h - 1, v);
+    }
+    for (int y = top; y < top + h; ++y) {
+        ref_pixel(s, left, y, v);
+        ref_pixel(s, left + w - 1, y, v);
+    }
+    if (fill) ref_fill_rect(s, left + 1, top + 1, w - 2, h - 2, v);
+}
+
+static void ref_line(ssd1306_t *s, int x0, int y0, int x1, int y1, bool v) {
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int err = dx - dy;
+    while (true) {
+        ref_pixel(s, x0, y0, v);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = err * 2;
+        if (e2 > -dy) { err -= dy; x0 += sx; }
+        if (e2 < dx) { err += dx; y0 += sy; }
+    }
+}
+
+static void ref_char(ssd1306_t *s, char c, int x, int y) {
+    uint16_t index = (c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0;
+    for (int i = 0; i < 8; ++i)
+        for (int j = 0; j < 8; ++j) ref_pixel(s, x + i, y + j, font[index + i] & (1 << j));
+}
+
+// --- Equivalência ---
+
+static ssd1306_t a, b;
+
+// Todo byte alterado precisa estar no retângulo marcado, senão não vai ao painel
+static bool marca_cobre(const ssd1306_t *s, const uint8_t *antes) {
+    for (int x = 0; x < s->width; x++) {
+        for (int p = 0; p < s->pages; p++) {
+            int i = x * s->pages + p;
+            if (antes[i] == s->ram_buffer[1 + i]) continue;
+            if (!s->dirty || x < s->dirty_x0 || x > s->dirty_x1 || p < s->dirty_p0 || p > s->dirty_p1) return false;
+        }
+    }
+    return true;
+}
+
+static void testar_equivalencia(void) {
+    uint8_t antes[128 * 8];
+    uint32_t divergencias = 0, fora_da_marca = 0;
+    srand(1);
+    for (int k = 0; k < 200000; k++) {
+        if (k % 64 == 0) {
+            for (size_t i = 1; i < a.bufsize; i++) a.ram_buffer[i] = b.ram_buffer[i] = (uint8_t)rand();
+        }
+        memcpy(antes, b.ram_buffer + 1, sizeof(antes));
+        b.dirty = false;
+        int x = rand() % 128, y = rand() % 64;
+        int w = 1 + rand() % (128 - x), h = 1 + rand() % (64 - y);
+        bool v = rand() & 1;
+        switch (rand() % 7) {
+            case 0: {
+                bool f = rand() & 1;
+                ref_rect(&a, y, x, w, h, v, f);
+                ssd1306_rect(&b, y, x, w, h, v, f);
+                break;
+            }
+            case 1:
+                ref_line(&a, x, y, x + w - 1, y, v);
+                ssd1306_hline(&b, x + w - 1, x, y, v);  // extremos em qualquer ordem
+                break;
+            case 2:
+                ref_line(&a, x, y, x, y + h - 1, v);
+                ssd1306_vline(&b, x, y + h - 1, y, v);
+                break;
+            case 3: {
+                int x1 = rand() % 128, y1 = rand() % 64;
+                ref_line(&a, x, y, x1, y1, v);
+                ssd1306_line(&b, x, y, x1, y1, v);
+                break;
+            }
+            case 4: {
+                // Retângulos parcialmente ou totalmente fora da tela
+                int cx = rand() % 200 - 40, cy = rand() % 120 - 30, cw = rand() % 100 - 5, ch = rand() % 60 - 5;
+                ref_fill_rect(&a, cx, cy, cw, ch, v);
+                ssd1306_fill_rect(&b, cx, cy, cw, ch, v);
+                break;
+            }
+            case 5: {
+                // Fora da tela e em qualquer alinhamento vertical
+                char c = (char)(rand() % 140);
+                int cx = rand() % 136, cy = rand() % 72;
+                ref_char(&a, c, cx, cy);
+                ssd1306_draw_char(&b, c, cx, cy);
+                break;
+            }
+            default:
+                ref_pixel(&a, x, y, v);
+                ssd1306_pixel(&b, x, y, v);
+                break;
+        }
+        if (memcmp(a.ram_buffer, b.ram_buffer, a.bufsize) != 0) {
+            if (divergencias++ == 0) printf("primeira divergência na operação %d\n", k);
+            memcpy(a.ram_buffer, b.ram_buffer, a.bufsize);
+        }
+        if (!marca_cobre(&b, antes)) fora_da_marca++;
+    }
+    VERIFICAR(divergencias == 0, "%u operações divergiram da referência", (unsigned)divergencias);
+    VERIFICAR(fora_da_marca == 0, "%u operações alteraram bytes fora da marca", (unsigned)fora_da_marca);
+}
+
+// scroll_left: as colunas de x0 + n em diante vão para x0, as n últimas ficam como estavam
+static void testar_scroll(void) {
+    srand(2);
+    uint32_t erros = 0;
+    for (int k = 0; k < 20000; k++) {
+        for (size_t i = 1; i < b.bufsize; i++) b.ram_buffer[i] = (uint8_t)rand();
+        memcpy(a.ram_buffer, b.ram_buffer, b.bufsize);
+        uint8_t x0 = rand() % 128, x1 = x0 + rand() % (128 - x0);
+        uint8_t p0 = rand() % 8, p1 = p0 + rand() % (8 - p0);
+        uint8_t n = 1 + rand() % 16;
+        ssd1306_scroll_left(&b, x0, x1, p0, p1, n);
+        for (int x = x0; n <= x1 - x0 && x <= x1 - n; x++)
+            for (int p = p0; p <= p1; p++) a.ram_buffer[1 + x * 8 + p] = a.ram_buffer[1 + (x + n) * 8 + p];
+        if (memcmp(a.ram_buffer, b.ram_buffer, a.bufsize) != 0) erros++;
+    }
+    VERIFICAR(erros == 0, "scroll_left divergiu em %u casos", (unsigned)erros);
+}
+
+// --- Bancada: antes (pixel a pixel) e depois (por página) ---
+
+static void comparar_custo(const char *nome, double antes, double depois) {
+    printf("  %-28s %9.1f ns %9.1f ns %6.1fx\n", nome, antes, depois, antes / depois);
+}
+
+static void bancada(void) {
+    const uint32_t n = 20000;
+    printf("bancada (host)                   antes       depois\n");
+    comparar_custo("limpar a tela",
+                   BANCADA_NS(n, ref_fill_rect(&a, 0, 0, 128, 64, _i & 1)),
+                   BANCADA_NS(n, ssd1306_fill(&b, _i & 1)));
+    comparar_custo("retângulo cheio 100x40",
+                   BANCADA_NS(n, ref_rect(&a, 10, 10, 100, 40, _i & 1, true)),
+                   BANCADA_NS(n, ssd1306_rect(&b, 10, 10, 100, 40, _i & 1, true)));
+    comparar_custo("moldura 124x60",
+                   BANCADA_NS(n, ref_rect(&a, 2, 2, 124, 60, _i & 1, false)),
+                   BANCADA_NS(n, ssd1306_rect(&b, 2, 2, 124, 60, _i & 1, false)));
+    comparar_custo("linha horizontal 124",
+                   BANCADA_NS(n, ref_line(&a, 2, 15, 125, 15, _i & 1)),
+                   BANCADA_NS(n, ssd1306_line(&b, 2, 15, 125, 15, _i & 1)));
+    comparar_custo("caractere alinhado (y=24)",
+                   BANCADA_NS(n, ref_char(&a, 'A' + _i % 26, (_i * 8) % 120, 24)),
+                   BANCADA_NS(n, ssd1306_draw_char(&b, 'A' + _i % 26, (_i * 8) % 120, 24)));
+    comparar_custo("caractere deslocado (y=20)",
+                   BANCADA_NS(n, ref_char(&a, 'A' + _i % 26, (_i * 8) % 120, 20)),
+                   BANCADA_NS(n, ssd1306_draw_char(&b, 'A' + _i % 26, (_i * 8) % 120, 20)));
+    // Quadro típico da tela de sensores: limpa, moldura, separador e 6 linhas de texto
+    comparar_custo("quadro da tela de sensores", BANCADA_NS(n, {
+                       ref_fill_rect(&a, 0, 0, 128, 64, false);
+                       ref_rect(&a, 2, 2, 124, 60, true, false);
+                       ref_line(&a, 2, 15, 125, 15, true);
+                       for (int l = 0; l < 6; l++)
+                           for (int c = 0; c < 14; c++) ref_char(&a, 'A' + c, 8 + c * 8, 6 + l * 9);
+                   }),
+                   BANCADA_NS(n, {
+                       ssd1306_fill(&b, false);
+                       ssd1306_rect(&b, 2, 2, 124, 60, true, false);
+                       ssd1306_line(&b, 2, 15, 125, 15, true);
+                       for (int l = 0; l < 6; l++)
+                           for (int c = 0; c < 14; c++) ssd1306_draw_char(&b, 'A' + c, 8 + c * 8, 6 + l * 9);
+                   }));
+}
+
+int main(void) {
+    ssd1306_init(&a, 128, 64, false, 0x3C, i2c1);
+    ssd1306_init(&b, 128, 64, false, 0x3C, i2c1);
+    testar_equivalencia();
+    testar_scroll();
+    bancada();
+    return host_resultado();
+}
@@ -0,0 +1,247 @@
+#include <stdlib.h>
+#include <string.h>
+#include "host.h"
+#include "oled_falso.h"
+#include "telas.h"
+#include "simulador.h"
+
+// Telas do display no host: cada tela é desenhada, enviada ao painel emulado e a GDDRAM
+// comparada com um quadro de referência em test/telas/<nome>.pbm. Os quadros obtidos são
+// gravados no diretório de execução para inspeção; com --gravar eles substituem as
+// referências. No fim, a bancada por tela: custo do desenho e bytes por quadro.
+//
+//   ./teste_telas            compara
+//   ./teste_telas --gravar   regrava test/telas/*.pbm depois de uma mudança intencional
+
+#define ENDERECO 0x3C
+
+// Mesmos parâmetros do firmware
+#define PERIODO_TENDENCIA_MS 28125
+#define PASSO_ESCALA_TEMP 50
+#define PASSO_ESCALA_PRESSAO 50
+
+// 400 kHz, 9 bits por byte (ACK incluído), sem contar START/STOP
+#define BARRAMENTO_US_POR_BYTE 22.5
+
+static OledFalso oled;
+static ssd1306_t ssd;
+static Telas telas;
+static Tendencia tend_temp, tend_pressao;
+static Simulador sim;
+static uint32_t agora_ms;
+static bool gravar;
+
+static void montar(void) {
+    barramento_falso_zerar();
+    host_definir_us(1000000);
+    oled_falso_init(&oled);
+    barramento_falso_conectar(i2c1, ENDERECO, oled_falso_dispositivo, &oled);
+    ssd1306_init(&ssd, 128, 64, false, ENDERECO, i2c1);
+    ssd1306_config(&ssd);
+    telas_init(&telas, &ssd);
+
+    tendencia_init(&tend_temp, PERIODO_TENDENCIA_MS, PASSO_ESCALA_TEMP);
+    tendencia_init(&tend_pressao, PERIODO_TENDENCIA_MS, PASSO_ESCALA_PRESSAO);
+    simulador_init(&sim, &PERFIL_FRENTE_FRIA, 22);
+    agora_ms = 0;
+}
+
+// Uma leitura por segundo do simulador nas duas tendências, como a tarefa de coleta
+static void alimentar(uint32_t ms) {
+    for (uint32_t fim = agora_ms + ms; agora_ms < fim; agora_ms += 1000) {
+        EstadoClima e;
+        if (simulador_medir(&sim, agora_ms, &e)) {
+            tendencia_adicionar(&tend_temp, e.temperatura, agora_ms);
+            tendencia_adicionar(&tend_pressao, e.pressao, agora_ms);
+        }
+    }
+}
+
+static DadosTela dados(void) {
+    return (DadosTela){
+        .temperatura = 2537,
+        .umidade = 6412,
+        .pressao = 101325,
+        .altitude = 1234,
+        .wifi_conectado = true,
+        .ip = "192.168.0.42",
+        .status = "Temperatura",
+        .tendencia_temperatura = &tend_temp,
+        .tendencia_pressao = &tend_pressao,
+    };
+}
+
+static void desenhar(TipoTela tela, const DadosTela *d) {
+    telas_desenhar(&telas, tela, d);
+    VERIFICAR(ssd1306_send_data(&ssd), "envio da tela %d falhou", tela);
+}
+
+// PBM ASCII (P1), 64 pixels por linha de texto para ficar dentro das 70 colunas do formato
+#define PBM_TAM (16 + OLED_FALSO_PAGINAS * 8 * (OLED_FALSO_COLUNAS + OLED_FALSO_COLUNAS / 64))
+
+static void escrever_pbm(FILE *f) {
+    fprintf(f, "P1\n%d %d\n", OLED_FALSO_COLUNAS, OLED_FALSO_PAGINAS * 8);
+    for (int y = 0; y < OLED_FALSO_PAGINAS * 8; y++) {
+        for (int x = 0; x < OLED_FALSO_COLUNAS; x++) {
+            fputc(oled_falso_pixel(&oled, x, y) ? '1' : '0', f);
+            if (x % 64 == 63) fputc('\n', f);
+        }
+    }
+}
+
+static bool ler_arquivo(const char *caminho, char *buf, size_t tam, size_t *len) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) return false;
+    *len = fread(buf, 1, tam, f);
+    fclose(f);
+    return true;
+}
+
+// Compara a GDDRAM com a referência 'nome' (ou a regrava) e deixa o quadro obtido em ./
+static void conferir(const char *nome) {
+    static char obtido[PBM_TAM], esperado[PBM_TAM];
+    char caminho[512];
+
+    FILE *f = fmemopen(obtido, sizeof(obtido), "w");
+    escrever_pbm(f);
+    size_t len = ftell(f);
+    fclose(f);
+    VERIFICAR(len < sizeof(obtido), "%s: PBM truncado", nome);
+
+    snprintf(caminho, sizeof(caminho), "tela_%s.pbm", nome);
+    f = fopen(caminho, "w");
+    if (f) {
+        fwrite(obtido, 1, len, f);
+        fclose(f);
+    }
+
+    snprintf(caminho, sizeof(caminho), "%s/%s.pbm", TELAS_DIR, nome);
+    if (gravar) {
+        f = fopen(caminho, "w");
+        VERIFICAR(f != NULL, "não deu para gravar %s", caminho);
+        if (f) {
+            fwrite(obtido, 1, len, f);
+            fclose(f);
+            printf("gravado %s\n", caminho);
+        }
+        return;
+    }
+    size_t len_esperado;
+    if (!ler_arquivo(caminho, esperado, sizeof(esperado), &len_esperado)) {
+        VERIFICAR(false, "%s não existe (rode com --gravar)", caminho);
+        return;
+    }
+    VERIFICAR(len == len_esperado && memcmp(obtido, esperado, len) == 0,
+              "%s difere da referência; o quadro obtido está em tela_%s.pbm", nome, nome);
+}
+
+static void testar_quadros(void) {
+    montar();
+    alimentar(3600 * 1000);  // uma hora: o anel das tendências cheio
+    DadosTela d = dados();
+
+    desenhar(TELA_SENSORES, &d);
+    conferir("sensores");
+
+    d.temp_umid_obsoletas = true;
+    d.pressao_obsoleta = true;
+    d.status = "Pressao";
+    desenhar(TELA_SENSORES, &d);
+    conferir("sensores_obsoletos");
+
+    d = dados();
+    desenhar(TELA_WIFI, &d);
+    conferir("wifi");
+
+    d.wifi_conectado = false;
+    desenhar(TELA_WIFI, &d);
+    conferir("wifi_desconectado");
+
+    d = dados();
+    desenhar(TELA_GRAFICO_TEMPERATURA, &d);
+    conferir("grafico_temperatura");
+
+    desenhar(TELA_GRAFICO_PRESSAO, &d);
+    conferir("grafico_pressao");
+}
+
+// O gráfico desenhado aos poucos (deslocamento + coluna nova) termina igual ao desenhado
+// de uma vez, com o anel enchendo, cheio e com mudanças de escala no caminho
+static void testar_grafico_incremental(void) {
+    static uint8_t incremental[WIDTH * HEIGHT / 8], completo[WIDTH * HEIGHT / 8];
+    montar();
+    DadosTela d = dados();
+    uint32_t divergentes = 0, reescalas = 0;
+    for (int quadro = 0; quadro < 300; quadro++) {
+        alimentar(PERIODO_TENDENCIA_MS * (1 + quadro % 3) / 2);
+        reescalas += tend_temp.reescalar;
+        telas_desenhar(&telas, TELA_GRAFICO_TEMPERATURA, &d);
+        ssd1306_save_frame(&ssd, incremental);
+
+        // O mesmo estado redesenhado do zero
+        telas_invalidar(&telas);
+        telas_desenhar(&telas, TELA_GRAFICO_TEMPERATURA, &d);
+        ssd1306_save_frame(&ssd, completo);
+        if (memcmp(incremental, completo, sizeof(completo)) != 0) divergentes++;
+    }
+    printf("gráfico incremental: 300 quadros, %u com mudança de escala\n", (unsigned)reescalas);
+    VERIFICAR(divergentes == 0, "%u quadros incrementais diferentes do desenho completo", (unsigned)divergentes);
+    VERIFICAR(reescalas > 0, "a série não mudou de escala; o caso não foi exercitado");
+}
+
+// Custo por tela em regime: desenho no host (ns) e bytes que a atualização parcial
+// põe no barramento, com o limite de quadros por segundo que esse volume impõe a 400 kHz
+static void bancada(void) {
+    const int n = 2000;
+    static const struct {
+        TipoTela tela;
+        const char *nome;
+    } casos[] = {
+        {TELA_SENSORES, "sensores"},
+        {TELA_WIFI, "wifi"},
+        {TELA_GRAFICO_TEMPERATURA, "gráfico temperatura"},
+        {TELA_GRAFICO_PRESSAO, "gráfico pressão"},
+    };
+
+    printf("tela                  desenho ns  bytes/quadro  quadros/s (barramento)\n");
+    for (size_t c = 0; c < sizeof(casos) / sizeof(casos[0]); c++) {
+        montar();
+        alimentar(3600 * 1000);
+        DadosTela d = dados();
+        desenhar(casos[c].tela, &d);  // primeiro quadro inteiro fora da conta
+
+        const RegistroBarramento *r = barramento_falso_registro(i2c1);
+        uint32_t b0 = r->bytes;
+        double ns = 0;
+        for (int i = 0; i < n; i++) {
+            // Como no firmware: os valores mudam a cada quadro e os gráficos ganham um ponto
+            // a cada PERIODO_TENDENCIA_MS; aqui um a cada quatro quadros
+            d.temperatura = 2537 + i % 50;
+            d.pressao = 101325 + i % 200;
+            if (i % 4 == 0) alimentar(PERIODO_TENDENCIA_MS);
+            double t0 = host_agora_ns();
+            telas_desenhar(&telas, casos[c].tela, &d);
+            ns += host_agora_ns() - t0;
+            ssd1306_send_data(&ssd);
+        }
+        double bytes = (double)(r->bytes - b0) / n;
+        if (bytes > 0) {
+            printf("%-22s %10.0f  %12.1f  %10.0f\n", casos[c].nome, ns / n, bytes,
+                   1e6 / (bytes * BARRAMENTO_US_POR_BYTE));
+        } else {
+            printf("%-22s %10.0f  %12.1f  %10s\n", casos[c].nome, ns / n, bytes, "-");
+        }
+        VERIFICAR(oled_falso_comparar(&oled, ssd.ram_buffer + 1, 128, 8) == 0, "%s: painel divergente",
+                  casos[c].nome);
+        // Nenhuma tela em regime pode custar um quadro inteiro (1024 bytes de imagem)
+        VERIFICAR(bytes < 1024, "%s: %.0f bytes por quadro", casos[c].nome, bytes);
+    }
+}
+
+int main(int argc, char **argv) {
+    gravar = argc > 1 && strcmp(argv[1], "--gravar") == 0;
+    testar_quadros();
+    testar_grafico_incremental();
+    if (!gravar) bancada();
+    return host_resultado();
+}